@@ -0,0 +1,860 @@
+//
+// Created by Jorge Jimenez on 7/11/25.
+//
+
+#include "Benchmarks.h"
+#include "../entitymanager/EntityManager.h"
+#include "../collision/Broadphase.h"
+#include "../collision/Narrowphase.h"
+#include "../physics/Integrator.h"
+#include "../render/BatchRenderer.h"
+#include "../systems/SpazbitSystem.h"
+#include "../systems/TweenSystem.h"
+#include "../systems/TimingWheel.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <utility>
+
+namespace
+{
+    /// Set once any benchmark's result disagrees with its reference, run() then fails
+    bool mismatched = false;
+
+    /// Records whether a result matched its reference, returns the note to print after it
+    const char* check(const bool matches)
+    {
+        if (!matches) mismatched = true;
+        return matches ? "" : "  MISMATCH";
+    }
+
+    /// Average wall time of one call to f, in milliseconds
+    template <typename F>
+    double timeIt(const int iterations, F&& f)
+    {
+        // warm up caches and branch predictors before measuring
+        f();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            f();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    }
+
+    /**
+     * @brief Fills an EntityManager with roughly the mix of entities a busy game has
+     *
+     * Mostly bullets and enemies, a few spazbits and one player, spread over a
+     * 1120x700 window like the default config unless another field size is given.
+     */
+    void populateWorld(EntityManager& entities, const size_t count, const Vec2f field = Vec2f(1120, 700))
+    {
+        std::mt19937 gen{ 42 };
+        std::uniform_real_distribution x(0.0f, field.x);
+        std::uniform_real_distribution y(0.0f, field.y);
+        std::uniform_real_distribution v(-3.0f, 3.0f);
+
+        const auto player = entities.addEntity("player");
+        entities.add<CTransform>(player, field / 2.0f, Vec2f(5, 5), 0.0f);
+        entities.add<CShape>(player, 10.0f, 8, sf::Color::White, sf::Color::White, 4.0f);
+        entities.add<CCollision>(player, 10.0f);
+        entities.add<CInput>(player);
+
+        for (size_t i = 1; i < count; i++)
+        {
+            const size_t kind = i % 20;
+            const std::string tag = kind < 10 ? "bullet" : kind < 19 ? "enemy" : "spazbit";
+            const auto e = entities.addEntity(tag);
+
+            entities.add<CTransform>(e, Vec2f(x(gen), y(gen)), Vec2f(v(gen), v(gen)), 0.0f);
+            entities.add<CShape>(e, kind < 10 ? 5.0f : 15.0f, kind < 10 ? 8 : 3 + kind % 6,
+                                 sf::Color::White, sf::Color::White, 2.0f);
+            entities.add<CCollision>(e, kind < 10 ? 5.0f : 15.0f);
+            entities.add<CLifespan>(e, 60, 0);
+            if (kind >= 10) entities.add<CScore>(e, 100);
+            if (kind == 19) entities.add<CSpazJump>(e);
+        }
+
+        entities.update();
+    }
+
+    /**
+     * @brief Bounce-and-advance over every non-player, non-spazbit entity, written the
+     * old way (filter every entity inside the loop) and with a typed view
+     */
+    void viewIteration()
+    {
+        std::printf("view-iteration: filter-in-loop vs view<CTransform, CShape>\n");
+        std::printf("%10s %16s %16s %10s\n", "entities", "filter (ms)", "view (ms)", "speedup");
+
+        for (const size_t count : { 1000, 10000, 50000, 100000 })
+        {
+            EntityManager entities;
+            populateWorld(entities, count);
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            const auto bounce = [](CTransform& transform, const CShape& shape) {
+                const float radius = shape.radius;
+                if (transform.pos.x - radius < 0 || transform.pos.x + radius > 1120) transform.velocity.x *= -1;
+                if (transform.pos.y - radius < 0 || transform.pos.y + radius > 700)  transform.velocity.y *= -1;
+                transform.pos += transform.velocity;
+            };
+
+            const double filter = timeIt(iterations, [&] {
+                for (const auto e : entities.getEntities())
+                {
+                    if (entities.tag(e) == "player" || entities.tag(e) == "spazbit") continue;
+                    if (entities.has<CTransform>(e) && entities.has<CShape>(e))
+                    {
+                        bounce(entities.get<CTransform>(e), entities.get<CShape>(e));
+                    }
+                }
+            });
+
+            const double view = timeIt(iterations, [&] {
+                entities.view<CTransform, const CShape>().without<CInput, CSpazJump>().each(bounce);
+            });
+
+            std::printf("%10zu %16.3f %16.3f %9.1fx\n", count, filter, view, filter / view);
+        }
+    }
+
+    /**
+     * @brief Fires and expires bullets at a constant rate, like holding the mouse down
+     *
+     * Once the pools are warm every frame recycles the slots, staging records and rows
+     * freed by the bullets that expired, so the manager's allocation counter should not
+     * move during the measured frames.
+     */
+    void bulletSoak()
+    {
+        constexpr size_t BulletsPerFrame = 64;
+        constexpr int    Lifespan        = 60;
+        constexpr int    WarmupFrames    = Lifespan * 2;
+        constexpr int    Frames          = 10000;
+
+        std::printf("bullet-soak: %zu bullets per frame, %d frame lifespan, %d frames\n",
+                    BulletsPerFrame, Lifespan, Frames);
+        std::printf("%10s %16s %16s %16s\n", "pool", "warmup allocs", "soak allocs", "frame (ms)");
+
+        for (const size_t pool : { size_t{0}, BulletsPerFrame * Lifespan })
+        {
+            EntityManager entities;
+            entities.reserve(pool);
+            const TagId bulletTag = entities.internTag("bullet");
+            TimingWheel expiries;
+            int tick = 0;
+
+            const auto frame = [&] {
+                for (size_t i = 0; i < BulletsPerFrame; i++)
+                {
+                    const auto bullet = entities.addEntity(bulletTag);
+                    const float angle = static_cast<float>(i) * 0.1f;
+                    entities.add<CTransform>(bullet, Vec2f(560, 350), Vec2f(std::cos(angle), std::sin(angle)) * 20.0f, 0.0f);
+                    entities.add<CShape>(bullet, 5.0f, 8, sf::Color::White, sf::Color::White, 2.0f);
+                    entities.add<CCollision>(bullet, 5.0f);
+                    entities.add<CLifespan>(bullet, Lifespan, tick);
+                    expiries.schedule(bullet, tick + Lifespan);
+                }
+
+                entities.view<CTransform>().each([](CTransform& transform) {
+                    transform.pos += transform.velocity;
+                });
+                expiries.advance(++tick, [&](const EntityHandle e) { entities.destroy(e); });
+
+                entities.update();
+            };
+
+            for (int i = 0; i < WarmupFrames; i++) frame();
+            const size_t warmup = entities.poolStats().heapAllocations;
+
+            const double ms = timeIt(Frames, frame);
+            const size_t soak = entities.poolStats().heapAllocations - warmup;
+
+            std::printf("%10zu %16zu %16zu %16.4f\n", pool, warmup, soak, ms);
+        }
+    }
+
+    /**
+     * @brief Bullet-vs-target search through every broadphase backend
+     *
+     * The field grows with the entity count so the density matches 1k entities in the
+     * default window, which is what a bigger level would look like. Targets drift a
+     * little every frame so the tree has to refit. The mixed run gives targets radii
+     * from small-enemy to four times enemy size, the case a fixed grid handles worst.
+     * Brute force is skipped past 10k entities, where it takes seconds per frame.
+     */
+    void broadphase()
+    {
+        std::printf("broadphase: bullets vs scoring targets through each backend\n");
+        std::printf("%10s %8s %10s %14s %14s %14s\n", "entities", "radii", "hits", "brute (ms)", "grid (ms)", "tree (ms)");
+
+        for (const size_t count : { 1000, 5000, 10000, 50000, 100000 })
+        {
+            for (const bool mixed : { false, true })
+            {
+                const float scale = std::sqrt(static_cast<float>(count) / 1000.0f);
+                EntityManager entities;
+                populateWorld(entities, count, Vec2f(1120, 700) * scale);
+
+                std::vector<CollisionProxy> bullets;
+                std::vector<CollisionProxy> targets;
+                std::vector<Vec2f> drift;
+                entities.view<const CTransform, const CCollision>().without<CScore, CInput>().each(
+                    [&](EntityHandle e, const CTransform& transform, const CCollision& collision) {
+                        bullets.push_back({ e, transform.pos, collision.radius, transform.velocity });
+                    });
+                entities.view<const CTransform, const CCollision, const CScore>().each(
+                    [&](EntityHandle e, const CTransform& transform, const CCollision& collision, const CScore&) {
+                        const float radius = mixed ? collision.radius * std::array{ 0.5f, 1.0f, 4.0f }[e.index % 3]
+                                                   : collision.radius;
+                        targets.push_back({ e, transform.pos, radius, {} });
+                        drift.push_back(transform.velocity);
+                    });
+
+                const int iterations = count >= 50000 ? 10 : 50;
+                std::vector<BroadphasePair> pairs;
+                size_t hits = 0;
+
+                const auto measure = [&](const BroadphaseType type) {
+                    auto backend = makeBroadphase(type, 30.0f);
+                    return timeIt(iterations, [&] {
+                        for (size_t i = 0; i < targets.size(); i++) targets[i].pos += drift[i];
+                        backend->update(targets);
+                        backend->findPairs(bullets, pairs);
+
+                        hits = 0;
+                        for (const auto& [query, target] : pairs)
+                        {
+                            const Vec2f diff = bullets[query].pos - target.pos;
+                            const float r = bullets[query].radius + target.radius;
+                            hits += diff.x * diff.x + diff.y * diff.y < r * r;
+                        }
+                    });
+                };
+
+                char brute[16] = "-";
+                if (count <= 10000) std::snprintf(brute, sizeof(brute), "%.3f", measure(BroadphaseType::BruteForce));
+                const double grid = measure(BroadphaseType::Grid);
+                const double tree = measure(BroadphaseType::Tree);
+
+                std::printf("%10zu %8s %10zu %14s %14.3f %14.3f\n", count, mixed ? "mixed" : "uniform", hits, brute, grid, tree);
+            }
+        }
+    }
+
+    /**
+     * @brief Circle overlap tests over packed candidate pairs, with each kernel the CPU supports
+     *
+     * Pairs are spread so about a third of them overlap, roughly what the broadphase
+     * hands over. Every kernel has to report the same hits as the scalar one.
+     */
+    void narrowphase()
+    {
+        constexpr size_t Pairs = 1 << 16;
+        std::printf("narrowphase: %zu candidate pairs, CPU supports %s\n", Pairs,
+                    SimdLevelNames[static_cast<int>(simdLevel())]);
+        std::printf("%10s %12s %14s %16s\n", "kernel", "hits", "time (ms)", "pairs per ns");
+
+        std::mt19937 gen{ 42 };
+        std::uniform_real_distribution offset(-40.0f, 40.0f);
+        std::uniform_real_distribution radius(5.0f, 15.0f);
+
+        Narrowphase batch;
+        for (size_t i = 0; i < Pairs; i++)
+        {
+            batch.add(Vec2f(0, 0), radius(gen), Vec2f(offset(gen), offset(gen)), radius(gen));
+        }
+
+        size_t expected = 0;
+        for (int level = 0; level <= static_cast<int>(simdLevel()); level++)
+        {
+            batch.setLevel(static_cast<SimdLevel>(level));
+            size_t hits = 0;
+            const double ms = timeIt(2000, [&] { hits = batch.run().size(); });
+
+            if (level == 0) expected = hits;
+            std::printf("%10s %12zu %14.3f %16.2f%s\n", SimdLevelNames[level], hits, ms,
+                        static_cast<double>(Pairs) / (ms * 1e6), check(hits == expected));
+        }
+    }
+
+    /**
+     * @brief How many bullets crossing a small enemy are caught, discrete vs swept
+     *
+     * Each bullet flies straight past a small enemy (radius 7.5) at a random sideways
+     * offset that always crosses it, one frame at a time. The discrete test only sees
+     * the end-of-frame positions, the swept test sees the whole path.
+     */
+    void bulletTunneling()
+    {
+        constexpr size_t Bullets = 10000;
+        constexpr float  BulletRadius = 5.0f;
+        constexpr float  EnemyRadius = 7.5f;
+
+        std::printf("bullet-tunneling: %zu bullets crossing a radius %.1f enemy\n", Bullets, EnemyRadius);
+        std::printf("%10s %14s %14s\n", "speed", "discrete (%)", "swept (%)");
+
+        std::mt19937 gen{ 42 };
+        std::uniform_real_distribution side(-(BulletRadius + EnemyRadius) * 0.99f, (BulletRadius + EnemyRadius) * 0.99f);
+        std::uniform_real_distribution phase(0.0f, 1.0f);
+
+        for (const float speed : { 5.0f, 10.0f, 20.0f, 40.0f, 80.0f })
+        {
+            size_t discrete = 0, swept = 0;
+            Narrowphase batch;
+            for (size_t b = 0; b < Bullets; b++)
+            {
+                // start a random fraction of a frame before the enemy's reach
+                const float y = side(gen);
+                float x = -100.0f - phase(gen) * speed;
+                bool seenDiscrete = false, seenSwept = false;
+                for (; x < 100.0f; x += speed)
+                {
+                    batch.clear();
+                    batch.add(Vec2f(x + speed, y), BulletRadius, Vec2f(0, 0), EnemyRadius);
+                    batch.add(Vec2f(x + speed, y), BulletRadius, Vec2f(0, 0), EnemyRadius, Vec2f(speed, 0));
+                    for (const uint32_t hit : batch.run())
+                    {
+                        if (hit == 0) seenDiscrete = true;
+                        else seenSwept = true;
+                    }
+                }
+                discrete += seenDiscrete;
+                swept += seenSwept;
+            }
+
+            std::printf("%10.0f %14.1f %14.1f\n", speed, 100.0 * discrete / Bullets, 100.0 * swept / Bullets);
+        }
+    }
+
+    /**
+     * @brief Bounce-and-advance per entity through a view vs the Integrator's kernels
+     *
+     * The Integrator timings include packing the radii, except for the scalar level,
+     * which runs Integrator::bounce() straight from the components like the game does.
+     * Every kernel must leave the bodies exactly where the per-entity loop does.
+     */
+    void movement()
+    {
+        std::printf("movement: per-entity view vs Integrator, CPU supports %s\n",
+                    SimdLevelNames[static_cast<int>(simdLevel())]);
+        std::printf("%10s %10s %14s %10s\n", "entities", "kernel", "time (ms)", "speedup");
+
+        const Vec2f bounds(1120, 700);
+        const auto bodies = [](EntityManager& entities) {
+            return entities.view<CTransform, const CShape>().without<CInput, CSpazJump>();
+        };
+        const auto bounce = [&](CTransform& transform, const CShape& shape) {
+            const float radius = shape.radius;
+            if (transform.pos.x - radius < 0 || transform.pos.x + radius > bounds.x) transform.velocity.x *= -1;
+            if (transform.pos.y - radius < 0 || transform.pos.y + radius > bounds.y) transform.velocity.y *= -1;
+            transform.pos += transform.velocity;
+        };
+        std::vector<float> radii;
+        const auto integrate = [&](EntityManager& entities, Integrator& integrator) {
+            bodies(entities).eachArchetype([&](Archetype& archetype) {
+                const auto transforms = archetype.column<CTransform>();
+                const auto shapes = archetype.column<CShape>();
+                if (integrator.level() == SimdLevel::Scalar)
+                {
+                    for (size_t i = 0; i < shapes.size(); i++) Integrator::bounce(transforms[i], shapes[i].radius, bounds);
+                    return;
+                }
+
+                radii.resize(shapes.size());
+                for (size_t i = 0; i < shapes.size(); i++) radii[i] = shapes[i].radius;
+                integrator.run(transforms, radii, bounds);
+            });
+        };
+        const auto positions = [&](EntityManager& entities) {
+            std::vector<Vec2f> result;
+            bodies(entities).each([&](const CTransform& transform, const CShape&) { result.push_back(transform.pos); });
+            return result;
+        };
+
+        for (const size_t count : { 1000, 10000, 100000 })
+        {
+            const int iterations = count >= 100000 ? 100 : 1000;
+
+            // every kernel steps the same world 100 ticks, then must match the per-entity loop
+            EntityManager reference;
+            populateWorld(reference, count, bounds);
+            for (int tick = 0; tick < 100; tick++) bodies(reference).each(bounce);
+            const auto expected = positions(reference);
+
+            const double view = timeIt(iterations, [&] { bodies(reference).each(bounce); });
+            std::printf("%10zu %10s %14.4f\n", count, "view", view);
+
+            Integrator integrator;
+            for (int level = 0; level <= static_cast<int>(simdLevel()); level++)
+            {
+                integrator.setLevel(static_cast<SimdLevel>(level));
+
+                EntityManager entities;
+                populateWorld(entities, count, bounds);
+                for (int tick = 0; tick < 100; tick++) integrate(entities, integrator);
+                const bool matches = positions(entities) == expected;
+
+                const double ms = timeIt(iterations, [&] { integrate(entities, integrator); });
+                std::printf("%10s %10s %14.4f %9.1fx%s\n", "", SimdLevelNames[level], ms, view / ms,
+                            check(matches));
+            }
+        }
+    }
+
+    /**
+     * @brief Spazbit jumps looked up and eased one entity at a time vs the batched system
+     *
+     * The per-entity version is the old Game::spazbitMovement: component lookups by
+     * handle, fresh distributions for every jump and the easing switch per spazbit.
+     */
+    void spazbits()
+    {
+        std::printf("spazbits: per-entity jumps vs SpazbitSystem\n");
+        std::printf("%10s %16s %16s %10s\n", "spazbits", "per-entity (ms)", "batched (ms)", "speedup");
+
+        const SpazbitSystem::Params params{ Vec2f(1120, 700), 2.0f, 6.0f };
+        for (const size_t count : { 1000, 10000, 50000 })
+        {
+            const auto spawn = [&](EntityManager& entities) {
+                std::mt19937 gen{ 42 };
+                std::uniform_real_distribution x(20.0f, 1100.0f);
+                std::uniform_real_distribution y(20.0f, 680.0f);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto e = entities.addEntity("spazbit");
+                    entities.add<CTransform>(e, Vec2f(x(gen), y(gen)), Vec2f(0, 0), 0.0f);
+                    entities.add<CShape>(e, 15.0f, 6, sf::Color::White, sf::Color::White, 2.0f);
+                    entities.add<CLifespan>(e, 2000, 0).setEasingType(EASEIN_EXPO);
+                    entities.add<CSpazJump>(e);
+                }
+                entities.update();
+            };
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            EntityManager single;
+            spawn(single);
+            Interpolate interpolations;
+            std::mt19937 gen{ 42 };
+            const double perEntity = timeIt(iterations, [&] {
+                single.view<CSpazJump>().each([&](const EntityHandle e, CSpazJump&) {
+                    auto& spaz = single.get<CSpazJump>(e);
+                    auto& transform = single.get<CTransform>(e);
+                    const float r = single.get<CShape>(e).getRadius();
+                    if (spaz.distanceTraveled >= spaz.distanceToTravel)
+                    {
+                        std::uniform_real_distribution angDist(0.0f, 2.0f * std::numbers::pi_v<float>);
+                        std::uniform_real_distribution speedDist(params.minSpeed, params.maxSpeed);
+                        std::uniform_real_distribution distDist(50.0f, 200.0f);
+                        const float angle = angDist(gen);
+                        const float speed = speedDist(gen);
+                        transform.velocity = Vec2f{ std::cos(angle) * speed, std::sin(angle) * speed };
+                        spaz.distanceToTravel = distDist(gen);
+                        spaz.distanceTraveled = 0.0f;
+                    }
+                    const float progress = spaz.distanceToTravel > 0.0f
+                        ? std::clamp(spaz.distanceTraveled / spaz.distanceToTravel, 0.0f, 1.0f) : 1.0f;
+                    transform.pos += transform.velocity * interpolations.interpolate(progress, single.get<CLifespan>(e).getEasing());
+                    if (transform.pos.x - r < 0.0f || transform.pos.x + r > params.bounds.x)
+                    {
+                        transform.velocity.x = -transform.velocity.x;
+                        transform.pos.x = std::clamp(transform.pos.x, r, params.bounds.x - r);
+                    }
+                    if (transform.pos.y - r < 0.0f || transform.pos.y + r > params.bounds.y)
+                    {
+                        transform.velocity.y = -transform.velocity.y;
+                        transform.pos.y = std::clamp(transform.pos.y, r, params.bounds.y - r);
+                    }
+                    spaz.distanceTraveled += 1.0f;
+                });
+            });
+
+            EntityManager batched;
+            spawn(batched);
+            SpazbitSystem system;
+            system.seed(42);
+            const double batch = timeIt(iterations, [&] {
+                batched.view<CTransform, CSpazJump, const CShape, const CLifespan>()
+                    .eachArchetype([&](Archetype& archetype) {
+                        system.update(archetype.column<CTransform>(), archetype.column<CSpazJump>(),
+                                      archetype.column<CShape>(), archetype.column<CLifespan>(), params);
+                    });
+            });
+
+            std::printf("%10zu %16.3f %16.3f %9.1fx\n", count, perEntity, batch, perEntity / batch);
+        }
+    }
+
+    /**
+     * @brief Accuracy and speed of the easing lookup tables against the exact curves
+     *
+     * Every value is eased by the exact interpolate(), switching on the curve per value,
+     * by the exact curve picked at compile time, and through the tables by each kernel.
+     * The error is the tables' largest difference from the exact curve, and every kernel
+     * must agree with the scalar table lookup bit for bit. Finally every value gets a
+     * random curve, eased one at a time vs sorted into EasingBuckets.
+     */
+    void easing()
+    {
+        constexpr size_t Values = 1 << 16;
+        std::printf("easing: %zu values per curve, %zu-sample tables, CPU supports %s\n", Values,
+                    Interpolate::LutSize, SimdLevelNames[static_cast<int>(simdLevel())]);
+        std::printf("%20s %10s %10s %10s", "curve", "max error", "switch", "policy");
+        for (int level = 0; level <= static_cast<int>(simdLevel()); level++) std::printf(" %10s", SimdLevelNames[level]);
+        std::printf("\n");
+
+        std::mt19937 gen{ 42 };
+        std::uniform_real_distribution progress(0.0f, 1.0f);
+        std::vector<float> in(Values), exact(Values), table(Values), out(Values);
+        for (float& t : in) t = progress(gen);
+        in[0] = 0.0f;
+        in[1] = 1.0f;
+
+        Interpolate interpolations;
+        for (int curve = 0; curve < INTERPOLATION_COUNT; curve++)
+        {
+            const auto type = static_cast<InterpolationType>(curve);
+            const double switchMs = timeIt(20, [&] {
+                for (size_t i = 0; i < Values; i++) exact[i] = interpolations.interpolate(in[i], type);
+            });
+            const double policyMs = timeIt(20, [&] {
+                Interpolate::withCurve(type, [&]<typename Curve>(Curve) {
+                    Interpolate::interpolateBatch<Curve>(in, out);
+                });
+            });
+
+            Interpolate::interpolateBatch(in, table, type, SimdLevel::Scalar);
+            float error = 0;
+            for (size_t i = 0; i < Values; i++) error = std::max(error, std::abs(table[i] - exact[i]));
+            std::printf("%20s %10.2e %10.2f %10.2f", InterpolationTypeNames[curve], error,
+                        switchMs * 1e6 / Values, policyMs * 1e6 / Values);
+
+            for (int level = 0; level <= static_cast<int>(simdLevel()); level++)
+            {
+                const double ms = timeIt(200, [&] {
+                    Interpolate::interpolateBatch(in, out, type, static_cast<SimdLevel>(level));
+                });
+                std::printf(" %10.2f%s", ms * 1e6 / Values, check(out == table));
+            }
+            std::printf("\n");
+        }
+
+        std::uniform_int_distribution anyCurve(0, INTERPOLATION_COUNT - 1);
+        std::vector<InterpolationType> curves(Values);
+        for (auto& curve : curves) curve = static_cast<InterpolationType>(anyCurve(gen));
+
+        const double oneByOne = timeIt(200, [&] {
+            for (size_t i = 0; i < Values; i++) out[i] = Interpolate::lookup(in[i], curves[i]);
+        });
+        EasingBuckets buckets;
+        const double bucketed = timeIt(200, [&] {
+            buckets.resize(Values);
+            std::copy(in.begin(), in.end(), buckets.in().begin());
+            std::copy(curves.begin(), curves.end(), buckets.curves().begin());
+            buckets.run();
+        });
+        std::copy(buckets.out().begin(), buckets.out().end(), table.begin());
+        std::printf("%20s %10s %10.2f %10.2f%s\n", "mixed, tables", "", oneByOne * 1e6 / Values,
+                    bucketed * 1e6 / Values, check(out == table));
+        std::printf("times are ns per value, mixed compares one lookup per value with EasingBuckets\n");
+    }
+
+    /**
+     * @brief Animating a radius and a color per entity, ad hoc vs TweenSystem
+     *
+     * The ad hoc version is what systems did before tweens: look every component up
+     * per entity and switch on each animation's curve for an exact ease. TweenSystem runs the same
+     * two animations per entity as tweens in its packed array. Durations are long
+     * enough that no tween finishes while timing.
+     */
+    void tweens()
+    {
+        std::printf("tweens: a radius and a color per entity, per-entity easing vs TweenSystem\n");
+        std::printf("%10s %10s %16s %16s %10s\n", "entities", "tweens", "per-entity (ms)", "tweens (ms)", "speedup");
+
+        constexpr int Duration = 1 << 20;
+        for (const size_t count : { 1000, 10000, 50000 })
+        {
+            std::vector<InterpolationType> radiusCurves(count), colorCurves(count);
+            const auto spawn = [&](EntityManager& entities) {
+                std::mt19937 gen{ 42 };
+                std::uniform_int_distribution anyCurve(0, INTERPOLATION_COUNT - 1);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto e = entities.addEntity("enemy");
+                    entities.add<CTransform>(e, Vec2f(0, 0), Vec2f(0, 0), 0.0f);
+                    entities.add<CShape>(e, 15.0f, 6, sf::Color::White, sf::Color::White, 2.0f);
+                    radiusCurves[i] = static_cast<InterpolationType>(anyCurve(gen));
+                    colorCurves[i] = static_cast<InterpolationType>(anyCurve(gen));
+                }
+                entities.update();
+            };
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            EntityManager single;
+            spawn(single);
+            Interpolate interpolations;
+            int tick = 0;
+            const double perEntity = timeIt(iterations, [&] {
+                tick++;
+                const float progress = static_cast<float>(tick) / Duration;
+                const auto& entities = single.getEntities();
+                for (size_t i = 0; i < entities.size(); i++)
+                {
+                    CShape& shape = single.get<CShape>(entities[i]);
+                    shape.setRadius(15.0f + 15.0f * interpolations.interpolate(progress, radiusCurves[i]));
+                    const auto channel = static_cast<uint8_t>(255.0f - 255.0f * interpolations.interpolate(progress, colorCurves[i]));
+                    shape.setFillColor(sf::Color(255, channel, channel, channel));
+                }
+            });
+
+            EntityManager tweened;
+            spawn(tweened);
+            TweenSystem system;
+            const auto& entities = tweened.getEntities();
+            for (size_t i = 0; i < entities.size(); i++)
+            {
+                system.add(entities[i], TWEEN_RADIUS, 15.0f, 30.0f, Duration, radiusCurves[i]);
+                system.add(entities[i], TWEEN_COLOR, sf::Color::White, sf::Color(255, 0, 0, 0), Duration, colorCurves[i]);
+            }
+            const double batch = timeIt(iterations, [&] { system.update(tweened); });
+
+            std::printf("%10zu %10zu %16.3f %16.3f %9.1fx\n", count, system.size(), perEntity, batch, perEntity / batch);
+        }
+    }
+
+    /**
+     * @brief Finding expired lifespans by checking every timed entity vs the timing wheel
+     *
+     * Lifespans are spread over 1 to 10 seconds and restarted as they run out, so the
+     * number of timed entities stays put. Checking every entity costs the same every
+     * tick whatever expires, the wheel only pays for the entities expiring that tick.
+     */
+    void lifespans()
+    {
+        constexpr int Ticks = 1200;
+        std::printf("lifespans: expiring timed entities over %d ticks, per-entity check vs timing wheel\n", Ticks);
+        std::printf("%10s %12s %16s %16s %10s\n", "entities", "expired", "check all (ms)", "wheel (ms)", "speedup");
+
+        for (const size_t count : { 10000, 100000, 500000 })
+        {
+            const auto spawn = [&](EntityManager& entities) {
+                std::mt19937 gen{ 42 };
+                std::uniform_int_distribution lifespan(60, 600);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const auto e = entities.addEntity("bullet");
+                    entities.add<CLifespan>(e, lifespan(gen), 0);
+                }
+                entities.update();
+            };
+
+            EntityManager checked;
+            spawn(checked);
+            size_t checkedExpired = 0;
+            int tick = 0;
+            const double checkAll = timeIt(Ticks, [&] {
+                tick++;
+                checked.view<CLifespan>().each([&](CLifespan& lifespan) {
+                    if (lifespan.expiresAt > tick) return;
+                    lifespan.expiresAt = tick + lifespan.lifespan;
+                    checkedExpired++;
+                });
+            });
+
+            EntityManager wheeled;
+            spawn(wheeled);
+            TimingWheel wheel;
+            for (const auto e : wheeled.getEntities())
+            {
+                wheel.schedule(e, wheeled.get<CLifespan>(e).expiresAt);
+            }
+            size_t wheelExpired = 0;
+            tick = 0;
+            const double wheelMs = timeIt(Ticks, [&] {
+                wheel.advance(++tick, [&](const EntityHandle e) {
+                    CLifespan* lifespan = wheeled.find<CLifespan>(e);
+                    if (!lifespan || lifespan->expiresAt > tick) return;
+                    lifespan->expiresAt = tick + lifespan->lifespan;
+                    wheel.schedule(e, lifespan->expiresAt);
+                    wheelExpired++;
+                });
+            });
+
+            std::printf("%10zu %12zu %16.4f %16.4f %9.1fx%s\n", count, wheelExpired, checkAll, wheelMs,
+                        checkAll / wheelMs, check(checkedExpired == wheelExpired));
+        }
+    }
+
+    /**
+     * @brief CPU side of drawing a frame with the batch renderer, no window needed
+     *
+     * Times build(), which writes every shape's fill and outline triangles into the
+     * renderer's vertex array, on one thread and on every hardware thread. Every render
+     * benchmark draws halfway through the 60 tick lifespans, so the fades are included.
+     */
+    void renderBatch()
+    {
+        std::printf("render-batch: building one vertex array for every shape, one thread against all of them\n");
+        std::printf("%10s %12s %13s %13s %8s %14s %8s\n", "entities", "vertices", "1 thread (ms)", "threaded (ms)",
+                    "threads", "ns per shape", "speedup");
+
+        for (const size_t count : { 1000, 10000, 50000, 100000 })
+        {
+            EntityManager entities;
+            populateWorld(entities, count);
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            BatchRenderer single;
+            single.setLifespanTime(30.0f);
+            single.setThreads(1);
+            const double singleMs = timeIt(iterations, [&] { single.build(entities, 0.5f); });
+
+            BatchRenderer threaded;
+            threaded.setLifespanTime(30.0f);
+            const double threadedMs = timeIt(iterations, [&] { threaded.build(entities, 0.5f); });
+
+            std::printf("%10zu %12zu %13.3f %13.3f %8zu %14.1f %7.2fx\n", count, threaded.stats().vertices, singleMs,
+                        threadedMs, threaded.stats().threads,
+                        threadedMs * 1e6 / static_cast<double>(threaded.stats().shapes), singleMs / threadedMs);
+        }
+    }
+
+    /**
+     * @brief Building the vertex array for a world twice the window's size each way,
+     * drawing everything vs culling against a window-sized view in the middle
+     */
+    void renderCull()
+    {
+        std::printf("render-cull: 2240x1400 world seen through a 1120x700 view\n");
+        std::printf("%10s %10s %10s %13s %13s %8s\n", "entities", "drawn", "culled", "all (ms)", "culled (ms)",
+                    "speedup");
+
+        const sf::View view(sf::Vector2f(1120, 700), sf::Vector2f(1120, 700));
+        for (const size_t count : { 1000, 10000, 50000, 100000 })
+        {
+            EntityManager entities;
+            populateWorld(entities, count, Vec2f(2240, 1400));
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            BatchRenderer everything;
+            everything.setLifespanTime(30.0f);
+            const double allMs = timeIt(iterations, [&] { everything.build(entities, 0.5f); });
+
+            BatchRenderer culling;
+            culling.setLifespanTime(30.0f);
+            const double culledMs = timeIt(iterations, [&] { culling.build(entities, 0.5f, view); });
+
+            std::printf("%10zu %10zu %10zu %13.3f %13.3f %7.2fx\n", count, culling.stats().shapes,
+                        culling.stats().culled, allMs, culledMs, allMs / culledMs);
+        }
+    }
+
+    /**
+     * @brief Building the vertex array with every shape's exact point count vs the
+     * level of detail from the default config, without and with its vertex budget
+     *
+     * The world also gets a quarter as many small enemies, half an enemy's radius with
+     * its 3 to 8 points, like the ones a dying enemy splits into.
+     */
+    void renderLod()
+    {
+        std::printf("render-lod: exact point counts vs level of detail (Lod 12 4 10 300000, player always exact)\n");
+        std::printf("%10s %12s %12s %12s %10s %13s %13s %13s\n", "entities", "exact verts", "lod verts",
+                    "budget verts", "stretch", "exact (ms)", "lod (ms)", "budget (ms)");
+
+        const sf::View view(sf::Vector2f(560, 350), sf::Vector2f(1120, 700));
+        for (const size_t count : { 1000, 10000, 50000, 100000 })
+        {
+            EntityManager entities;
+            populateWorld(entities, count);
+            std::mt19937 gen{ 7 };
+            std::uniform_real_distribution x(0.0f, 1120.0f);
+            std::uniform_real_distribution y(0.0f, 700.0f);
+            for (size_t i = 0; i < count / 4; i++)
+            {
+                const auto e = entities.addEntity("Small Enemy");
+                entities.add<CTransform>(e, Vec2f(x(gen), y(gen)), Vec2f(1, 1), 0.0f);
+                entities.add<CShape>(e, 7.5f, 3 + i % 6, sf::Color::White, sf::Color::White, 2.0f);
+                entities.add<CLifespan>(e, 60, 0);
+            }
+            entities.update();
+            const int iterations = count >= 50000 ? 20 : 200;
+
+            BatchRenderer exact;
+            exact.setLifespanTime(30.0f);
+            const double exactMs = timeIt(iterations, [&] { exact.build(entities, 0.5f, view); });
+
+            BatchRenderer lod;
+            lod.setLifespanTime(30.0f);
+            lod.setLevelOfDetail({ 12.0f, 4, 10.0f, 0 });
+            const double lodMs = timeIt(iterations, [&] { lod.build(entities, 0.5f, view); });
+
+            // the budget settles over a few frames, time it once it has
+            BatchRenderer budget;
+            budget.setLifespanTime(30.0f);
+            budget.setLevelOfDetail({ 12.0f, 4, 10.0f, 300000 });
+            for (int i = 0; i < 10; i++) budget.build(entities, 0.5f, view);
+            const double budgetMs = timeIt(iterations, [&] { budget.build(entities, 0.5f, view); });
+
+            std::printf("%10zu %12zu %12zu %12zu %9.2fx %13.3f %13.3f %13.3f\n", count, exact.stats().vertices,
+                        lod.stats().vertices, budget.stats().vertices, budget.stats().edgeScale, exactMs, lodMs,
+                        budgetMs);
+        }
+    }
+
+    const std::vector<std::pair<std::string, std::function<void()>>> registry = {
+        { "view-iteration", viewIteration },
+        { "bullet-soak", bulletSoak },
+        { "broadphase", broadphase },
+        { "narrowphase", narrowphase },
+        { "bullet-tunneling", bulletTunneling },
+        { "movement", movement },
+        { "spazbits", spazbits },
+        { "easing", easing },
+        { "tweens", tweens },
+        { "lifespans", lifespans },
+        { "render-batch", renderBatch },
+        { "render-cull", renderCull },
+        { "render-lod", renderLod },
+    };
+}
+
+int benchmarks::run(const std::vector<std::string>& names)
+{
+    int result = 0;
+    for (const auto& name : names)
+    {
+        const bool known = std::any_of(registry.begin(), registry.end(),
+            [&](const auto& entry) { return entry.first == name; });
+        if (!known)
+        {
+            std::fprintf(stderr, "Unknown benchmark: %s\n", name.c_str());
+            result = 1;
+        }
+    }
+
+    for (const auto& [name, benchmark] : registry)
+    {
+        if (!names.empty() && std::find(names.begin(), names.end(), name) == names.end()) continue;
+        benchmark();
+        std::printf("\n");
+    }
+
+    if (mismatched)
+    {
+        std::fprintf(stderr, "A benchmark's result did not match its reference, see MISMATCH above\n");
+        result = 1;
+    }
+
+    return result;
+}
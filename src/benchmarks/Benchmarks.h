@@ -0,0 +1,31 @@
+//
+// Created by Jorge Jimenez on 7/11/25.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Headless micro-benchmarks for the engine's hot paths
+ *
+ * Benchmarks build their own EntityManager worlds and never open a window, so they
+ * run on machines without a GPU. They are reached from the command line:
+ *
+ * @example
+ * ./CMakeLearn --bench                  # run every benchmark
+ * ./CMakeLearn --bench view-iteration   # run only the named ones
+ */
+namespace benchmarks
+{
+    /**
+     * @brief Runs the named benchmarks, or all of them when names is empty
+     *
+     * Benchmarks that check their results against a reference, like the SIMD kernels
+     * against the scalar ones, print MISMATCH next to any that disagree.
+     *
+     * @return 0 on success, 1 if an unknown benchmark was requested or any result mismatched
+     */
+    int run(const std::vector<std::string>& names);
+}
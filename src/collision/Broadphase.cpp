@@ -0,0 +1,137 @@
+//
+// Created by Jorge Jimenez on 7/19/25.
+//
+
+#include "Broadphase.h"
+#include "DynamicAabbTree.h"
+#include <iterator>
+
+namespace
+{
+    /// Smallest circle around everything the query's circle touched during its motion
+    CollisionProxy sweptBounds(const CollisionProxy& query)
+    {
+        CollisionProxy bounds = query;
+        bounds.pos    = query.pos - query.motion / 2.0f;
+        bounds.radius = query.radius + query.motion.dist(Vec2f(0, 0)) / 2.0f;
+        return bounds;
+    }
+
+    /// Every target is a candidate for every query, the baseline the others are measured against
+    class BruteForceBroadphase final : public Broadphase
+    {
+        std::vector<CollisionProxy> m_targets;
+
+    public:
+        [[nodiscard]] BroadphaseType type() const override
+        {
+            return BroadphaseType::BruteForce;
+        }
+
+        void update(const std::span<const CollisionProxy> targets) override
+        {
+            m_targets.assign(targets.begin(), targets.end());
+        }
+
+        void findPairs(const std::span<const CollisionProxy> queries, std::vector<BroadphasePair>& pairs) override
+        {
+            pairs.clear();
+            for (uint32_t q = 0; q < queries.size(); q++)
+            {
+                for (const auto& target : m_targets) pairs.push_back({ q, target });
+            }
+        }
+    };
+
+    /// Uniform grid rebuilt from scratch every frame, best when radii are similar
+    class GridBroadphase final : public Broadphase
+    {
+        SpatialHash m_grid;
+
+    public:
+        explicit GridBroadphase(const float cellSize)
+            : m_grid(cellSize)
+        {}
+
+        [[nodiscard]] BroadphaseType type() const override
+        {
+            return BroadphaseType::Grid;
+        }
+
+        void update(const std::span<const CollisionProxy> targets) override
+        {
+            m_grid.rebuild(targets);
+        }
+
+        void findPairs(const std::span<const CollisionProxy> queries, std::vector<BroadphasePair>& pairs) override
+        {
+            pairs.clear();
+            for (uint32_t q = 0; q < queries.size(); q++)
+            {
+                const CollisionProxy bounds = sweptBounds(queries[q]);
+                m_grid.query(bounds.pos, bounds.radius, [&](const CollisionProxy& target) {
+                    pairs.push_back({ q, target });
+                });
+            }
+        }
+    };
+
+    /// Dynamic AABB tree kept between frames, best when radii vary a lot
+    class TreeBroadphase final : public Broadphase
+    {
+        DynamicAabbTree m_tree;
+
+    public:
+        explicit TreeBroadphase(const float margin)
+            : m_tree(margin)
+        {}
+
+        [[nodiscard]] BroadphaseType type() const override
+        {
+            return BroadphaseType::Tree;
+        }
+
+        void update(const std::span<const CollisionProxy> targets) override
+        {
+            m_tree.update(targets);
+        }
+
+        void findPairs(const std::span<const CollisionProxy> queries, std::vector<BroadphasePair>& pairs) override
+        {
+            pairs.clear();
+            for (uint32_t q = 0; q < queries.size(); q++)
+            {
+                const auto& query = queries[q];
+                const Aabb swept = Aabb::merge(Aabb::around(query.pos - query.motion, query.radius),
+                                               Aabb::around(query.pos, query.radius));
+                m_tree.query(swept, [&](const CollisionProxy& target) {
+                    pairs.push_back({ q, target });
+                });
+            }
+        }
+    };
+}
+
+std::optional<BroadphaseType> broadphaseFromName(const std::string_view name)
+{
+    for (size_t i = 0; i < std::size(BroadphaseNames); i++)
+    {
+        if (name == BroadphaseNames[i]) return static_cast<BroadphaseType>(i);
+    }
+    return std::nullopt;
+}
+
+std::unique_ptr<Broadphase> makeBroadphase(const BroadphaseType type, const float cellSize)
+{
+    switch (type)
+    {
+        case BroadphaseType::Tree:
+            // a quarter of a diameter absorbs a few frames of enemy movement
+            return std::make_unique<TreeBroadphase>(cellSize * 0.25f);
+        case BroadphaseType::BruteForce:
+            return std::make_unique<BruteForceBroadphase>();
+        case BroadphaseType::Grid:
+        default:
+            return std::make_unique<GridBroadphase>(cellSize);
+    }
+}
@@ -0,0 +1,80 @@
+//
+// Created by Jorge Jimenez on 7/19/25.
+//
+
+#pragma once
+
+#include "SpatialHash.h"
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/// Available broadphase backends, see makeBroadphase()
+enum class BroadphaseType
+{
+    Grid,
+    Tree,
+    BruteForce,
+};
+
+/// Names used by the config file and the options panel, in the same order as BroadphaseType
+inline constexpr const char* BroadphaseNames[] = {
+    "grid",
+    "tree",
+    "brute",
+};
+
+/// Parses a BroadphaseNames entry, returning nothing for unknown names
+std::optional<BroadphaseType> broadphaseFromName(std::string_view name);
+
+/// A query circle together with one target it might overlap
+struct BroadphasePair
+{
+    uint32_t       query;  ///< Index into the queries passed to findPairs()
+    CollisionProxy target; ///< Target as given to the last update()
+};
+
+/**
+ * @brief Finds which targets might overlap each query circle
+ *
+ * Backends trade build cost against query cost differently, so sCollision talks to
+ * this interface and the backend can be swapped at runtime. Every backend reports a
+ * superset of the overlapping pairs, callers still run the exact circle test.
+ *
+ * Queries are swept: a query with a non-zero motion is matched against everything
+ * near its whole path from pos - motion to pos, not only where it ended up.
+ *
+ * @example
+ * auto broadphase = makeBroadphase(BroadphaseType::Tree, 30.0f);
+ * broadphase->update(targets);
+ * broadphase->findPairs(bullets, pairs);
+ * for (const auto& [query, target] : pairs) { ... }
+ */
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    [[nodiscard]] virtual BroadphaseType type() const = 0;
+
+    /**
+     * @brief Brings the structure in line with this frame's targets
+     *
+     * Targets are matched to the previous frame's by entity handle, so backends that
+     * persist between frames only touch the ones that moved, appeared or vanished.
+     */
+    virtual void update(std::span<const CollisionProxy> targets) = 0;
+
+    /// Replaces pairs with the candidates for every query's swept path, grouped by query in order
+    virtual void findPairs(std::span<const CollisionProxy> queries, std::vector<BroadphasePair>& pairs) = 0;
+};
+
+/**
+ * @brief Creates a broadphase backend
+ *
+ * @param cellSize Typical collision diameter, used as the grid's cell size and to
+ *                 size the tree's fattened bounds
+ */
+std::unique_ptr<Broadphase> makeBroadphase(BroadphaseType type, float cellSize);
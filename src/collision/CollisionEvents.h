@@ -0,0 +1,61 @@
+//
+// Created by Jorge Jimenez on 7/22/25.
+//
+
+#pragma once
+
+#include "../entity/Entity.h"
+#include <array>
+#include <span>
+#include <vector>
+
+/// Two entities that touched during the last collision step
+struct CollisionEvent
+{
+    EntityHandle   a;
+    EntityHandle   b;
+    CollisionLayer layerA;  ///< Never after layerB in CollisionLayer order
+    CollisionLayer layerB;
+    float          time;    ///< Fraction of a's swept motion at first contact, 0 if not swept
+};
+
+/**
+ * @brief Double-buffered stream of collision events
+ *
+ * Detection only reads the world and emits events into the back buffer, then
+ * publishes them. Gameplay systems react afterwards by reading the published events,
+ * which stay untouched while the next detection pass fills the other buffer. Both
+ * buffers keep their capacity, so a steady stream of events doesn't allocate.
+ *
+ * @example
+ * // detection
+ * events.emit({ bullet, enemy, LAYER_BULLET, LAYER_ENEMY, 0.5f });
+ * events.publish();
+ *
+ * // response
+ * for (const auto& event : events.published()) { ... }
+ */
+class CollisionEventBuffer
+{
+    std::array<std::vector<CollisionEvent>, 2> m_buffers;
+    size_t                                     m_back = 0;
+
+public:
+    void emit(const CollisionEvent& event)
+    {
+        m_buffers[m_back].push_back(event);
+    }
+
+    /// Makes the events emitted since the last publish() readable and starts a new batch
+    void publish()
+    {
+        m_back ^= 1;
+        m_buffers[m_back].clear();
+    }
+
+    /// Events from the last published detection pass
+    [[nodiscard]] std::span<const CollisionEvent> published() const
+    {
+        return m_buffers[m_back ^ 1];
+    }
+};
@@ -0,0 +1,14 @@
+//
+// Created by Jorge Jimenez on 7/22/25.
+//
+
+#include "CollisionLayers.h"
+
+std::optional<CollisionLayer> collisionLayerFromName(const std::string_view name)
+{
+    for (size_t i = 0; i < std::size(CollisionLayerNames); i++)
+    {
+        if (name == CollisionLayerNames[i]) return static_cast<CollisionLayer>(i);
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,73 @@
+//
+// Created by Jorge Jimenez on 7/22/25.
+//
+
+#pragma once
+
+#include "../components/Components.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/// Names used by the config file and the options panel, in the same order as CollisionLayer
+inline constexpr const char* CollisionLayerNames[] = {
+    "bullet",
+    "player",
+    "enemy",
+};
+
+static_assert(std::size(CollisionLayerNames) == LAYER_COUNT, "every collision layer needs a name");
+
+/// Parses a CollisionLayerNames entry, returning nothing for unknown names
+std::optional<CollisionLayer> collisionLayerFromName(std::string_view name);
+
+/**
+ * @brief Symmetric table of which collision layers are tested against each other
+ *
+ * Each layer has a bit mask of the layers it collides with, so a lookup is one AND.
+ *
+ * @example
+ * CollisionMatrix matrix;
+ * matrix.enable(LAYER_BULLET, LAYER_ENEMY);
+ * matrix.collides(LAYER_ENEMY, LAYER_BULLET); // true
+ */
+class CollisionMatrix
+{
+    std::array<uint32_t, LAYER_COUNT> m_masks{};
+
+public:
+    /// Bullets hit enemies and enemies hit the player
+    [[nodiscard]] static CollisionMatrix defaults()
+    {
+        CollisionMatrix matrix;
+        matrix.enable(LAYER_BULLET, LAYER_ENEMY);
+        matrix.enable(LAYER_PLAYER, LAYER_ENEMY);
+        return matrix;
+    }
+
+    void enable(const CollisionLayer a, const CollisionLayer b, const bool enabled = true)
+    {
+        if (enabled)
+        {
+            m_masks[a] |= 1u << b;
+            m_masks[b] |= 1u << a;
+        }
+        else
+        {
+            m_masks[a] &= ~(1u << b);
+            m_masks[b] &= ~(1u << a);
+        }
+    }
+
+    [[nodiscard]] bool collides(const CollisionLayer a, const CollisionLayer b) const
+    {
+        return (m_masks[a] & (1u << b)) != 0;
+    }
+
+    /// Layers that a collides with, one bit per CollisionLayer
+    [[nodiscard]] uint32_t mask(const CollisionLayer a) const
+    {
+        return m_masks[a];
+    }
+};
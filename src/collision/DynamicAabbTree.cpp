@@ -0,0 +1,291 @@
+//
+// Created by Jorge Jimenez on 7/19/25.
+//
+
+#include "DynamicAabbTree.h"
+#include <algorithm>
+
+DynamicAabbTree::DynamicAabbTree(const float margin)
+    : m_margin(margin)
+{}
+
+int32_t DynamicAabbTree::allocateNode()
+{
+    if (!m_freeNodes.empty())
+    {
+        const int32_t node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        m_nodes[node] = Node{};
+        return node;
+    }
+
+    m_nodes.emplace_back();
+    return static_cast<int32_t>(m_nodes.size() - 1);
+}
+
+void DynamicAabbTree::freeNode(const int32_t node)
+{
+    m_freeNodes.push_back(node);
+}
+
+void DynamicAabbTree::refit(int32_t node)
+{
+    while (node != Null)
+    {
+        node = balance(node);
+
+        Node& n = m_nodes[node];
+        n.height = 1 + std::max(m_nodes[n.left].height, m_nodes[n.right].height);
+        n.box    = Aabb::merge(m_nodes[n.left].box, m_nodes[n.right].box);
+        node = n.parent;
+    }
+}
+
+int32_t DynamicAabbTree::balance(const int32_t node)
+{
+    const Node& n = m_nodes[node];
+    if (n.isLeaf() || n.height < 2) return node;
+
+    const int32_t skew = m_nodes[n.right].height - m_nodes[n.left].height;
+    if (skew > 1) return rotateUp(node, n.right, n.left);
+    if (skew < -1) return rotateUp(node, n.left, n.right);
+    return node;
+}
+
+int32_t DynamicAabbTree::rotateUp(const int32_t node, const int32_t child, const int32_t other)
+{
+    // child takes node's place, node keeps other plus child's shorter subtree
+    Node& a = m_nodes[node];
+    Node& c = m_nodes[child];
+    const int32_t taller = m_nodes[c.left].height > m_nodes[c.right].height ? c.left : c.right;
+    const int32_t shorter = taller == c.left ? c.right : c.left;
+
+    c.parent = a.parent;
+    a.parent = child;
+    if (c.parent == Null) m_root = child;
+    else if (m_nodes[c.parent].left == node) m_nodes[c.parent].left = child;
+    else m_nodes[c.parent].right = child;
+
+    // node goes where child's shorter subtree was, that subtree goes where child was
+    if (a.left == child) a.left = shorter;
+    else a.right = shorter;
+    m_nodes[shorter].parent = node;
+
+    c.left  = node;
+    c.right = taller;
+
+    a.height = 1 + std::max(m_nodes[other].height, m_nodes[shorter].height);
+    a.box    = Aabb::merge(m_nodes[other].box, m_nodes[shorter].box);
+    c.height = 1 + std::max(a.height, m_nodes[taller].height);
+    c.box    = Aabb::merge(a.box, m_nodes[taller].box);
+    return child;
+}
+
+void DynamicAabbTree::insertLeaf(const int32_t leaf)
+{
+    if (m_root == Null)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = Null;
+        return;
+    }
+
+    // walk down towards the sibling that makes the tree grow the least
+    const Aabb box = m_nodes[leaf].box;
+    int32_t sibling = m_root;
+    while (!m_nodes[sibling].isLeaf())
+    {
+        const Node& node = m_nodes[sibling];
+        const float combined = Aabb::merge(node.box, box).cost();
+
+        // cost of making the leaf this node's sibling, vs pushing it further down
+        const float here = 2.0f * combined;
+        const float inherited = 2.0f * (combined - node.box.cost());
+
+        const auto descendCost = [&](const int32_t child) {
+            const Node& c = m_nodes[child];
+            const float merged = Aabb::merge(c.box, box).cost();
+            return (c.isLeaf() ? merged : merged - c.box.cost()) + inherited;
+        };
+
+        const float left = descendCost(node.left);
+        const float right = descendCost(node.right);
+        if (here < left && here < right) break;
+
+        sibling = left < right ? node.left : node.right;
+    }
+
+    // splice a new parent in above the sibling
+    const int32_t oldParent = m_nodes[sibling].parent;
+    const int32_t newParent = allocateNode();
+    Node& parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.left   = sibling;
+    parent.right  = leaf;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent    = newParent;
+
+    if (oldParent == Null)
+    {
+        m_root = newParent;
+    }
+    else if (m_nodes[oldParent].left == sibling)
+    {
+        m_nodes[oldParent].left = newParent;
+    }
+    else
+    {
+        m_nodes[oldParent].right = newParent;
+    }
+
+    refit(newParent);
+}
+
+void DynamicAabbTree::removeLeaf(const int32_t leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = Null;
+        return;
+    }
+
+    // the parent goes away and the sibling takes its place
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grandParent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == Null)
+    {
+        m_root = sibling;
+    }
+    else
+    {
+        if (m_nodes[grandParent].left == parent) m_nodes[grandParent].left = sibling;
+        else m_nodes[grandParent].right = sibling;
+        refit(grandParent);
+    }
+    freeNode(parent);
+}
+
+void DynamicAabbTree::update(const std::span<const CollisionProxy> targets)
+{
+    m_stamp++;
+    m_reinserted = 0;
+
+    for (const auto& target : targets)
+    {
+        const uint32_t slot = target.entity.index;
+        if (slot >= m_leafOfSlot.size()) m_leafOfSlot.resize(slot + 1, Null);
+
+        const Aabb tight = Aabb::around(target.pos, target.radius);
+        int32_t leaf = m_leafOfSlot[slot];
+
+        if (leaf == Null)
+        {
+            leaf = allocateNode();
+            m_leaves.push_back(leaf);
+            m_leafOfSlot[slot] = leaf;
+            m_nodes[leaf].parent = Null;
+        }
+        else if (m_nodes[leaf].proxy.entity == target.entity && m_nodes[leaf].box.contains(tight))
+        {
+            m_nodes[leaf].proxy = target;
+            m_nodes[leaf].stamp = m_stamp;
+            continue;
+        }
+        else
+        {
+            // moved out of its fat box, or a new entity reusing a dead entity's slot
+            removeLeaf(leaf);
+            m_reinserted++;
+        }
+
+        Node& node = m_nodes[leaf];
+        node.proxy = target;
+        node.stamp = m_stamp;
+        node.box   = Aabb::around(target.pos, target.radius + m_margin);
+        m_pending.push_back(leaf);
+    }
+
+    // drop the leaves of targets that are gone
+    size_t write = 0;
+    for (const int32_t leaf : m_leaves)
+    {
+        if (m_nodes[leaf].stamp != m_stamp)
+        {
+            removeLeaf(leaf);
+            freeNode(leaf);
+            m_leafOfSlot[m_nodes[leaf].proxy.entity.index] = Null;
+            continue;
+        }
+        m_leaves[write++] = leaf;
+    }
+    m_leaves.resize(write);
+
+    if (m_pending.size() * RebuildFraction > m_leaves.size())
+    {
+        rebuild();
+    }
+    else
+    {
+        for (const int32_t leaf : m_pending) insertLeaf(leaf);
+    }
+    m_pending.clear();
+}
+
+void DynamicAabbTree::rebuild()
+{
+    // recycle every internal node, leaves pending insertion aren't in the tree yet
+    if (m_root != Null)
+    {
+        m_stack.clear();
+        m_stack.push_back(m_root);
+        while (!m_stack.empty())
+        {
+            const int32_t node = m_stack.back();
+            m_stack.pop_back();
+            if (m_nodes[node].isLeaf()) continue;
+
+            m_stack.push_back(m_nodes[node].left);
+            m_stack.push_back(m_nodes[node].right);
+            freeNode(node);
+        }
+    }
+
+    m_root = m_leaves.empty() ? Null : build(m_leaves);
+    if (m_root != Null) m_nodes[m_root].parent = Null;
+}
+
+int32_t DynamicAabbTree::build(const std::span<int32_t> leaves)
+{
+    if (leaves.size() == 1) return leaves[0];
+
+    // split at the median centre along the longer side of the centres' bounds
+    Aabb centres{ m_nodes[leaves[0]].proxy.pos, m_nodes[leaves[0]].proxy.pos };
+    for (const int32_t leaf : leaves)
+    {
+        centres = Aabb::merge(centres, Aabb::around(m_nodes[leaf].proxy.pos, 0.0f));
+    }
+    const bool splitX = centres.max.x - centres.min.x > centres.max.y - centres.min.y;
+
+    const auto middle = leaves.begin() + static_cast<std::ptrdiff_t>(leaves.size() / 2);
+    std::nth_element(leaves.begin(), middle, leaves.end(), [&](const int32_t a, const int32_t b) {
+        return splitX ? m_nodes[a].proxy.pos.x < m_nodes[b].proxy.pos.x
+                      : m_nodes[a].proxy.pos.y < m_nodes[b].proxy.pos.y;
+    });
+
+    const int32_t left  = build(leaves.first(leaves.size() / 2));
+    const int32_t right = build(leaves.subspan(leaves.size() / 2));
+
+    // allocateNode() can grow m_nodes, so look the children up again afterwards
+    const int32_t node = allocateNode();
+    Node& n = m_nodes[node];
+    n.left   = left;
+    n.right  = right;
+    n.height = 1 + std::max(m_nodes[left].height, m_nodes[right].height);
+    n.box    = Aabb::merge(m_nodes[left].box, m_nodes[right].box);
+    m_nodes[left].parent  = node;
+    m_nodes[right].parent = node;
+    return node;
+}
@@ -0,0 +1,154 @@
+//
+// Created by Jorge Jimenez on 7/19/25.
+//
+
+#pragma once
+
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// Axis-aligned bounding box
+struct Aabb
+{
+    Vec2f min;
+    Vec2f max;
+
+    [[nodiscard]] static Aabb around(const Vec2f pos, const float radius)
+    {
+        return { Vec2f(pos.x - radius, pos.y - radius), Vec2f(pos.x + radius, pos.y + radius) };
+    }
+
+    [[nodiscard]] static Aabb merge(const Aabb& a, const Aabb& b)
+    {
+        return { Vec2f(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+                 Vec2f(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)) };
+    }
+
+    /// Half the perimeter, the 2D stand-in for surface area in the insertion cost
+    [[nodiscard]] float cost() const
+    {
+        return (max.x - min.x) + (max.y - min.y);
+    }
+
+    [[nodiscard]] bool contains(const Aabb& other) const
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && max.x >= other.max.x && max.y >= other.max.y;
+    }
+
+    [[nodiscard]] bool overlaps(const Aabb& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+    }
+};
+
+/**
+ * @brief Dynamic bounding-volume tree over collision circles
+ *
+ * Leaves store a fattened AABB, the circle's bounds grown by a margin, so a target that
+ * moves a little stays inside its leaf and the tree is left alone. Only targets that
+ * leave their fat bounds are removed and reinserted, after which the boxes of their
+ * ancestors are refit. New leaves pick the sibling that grows the tree's total box
+ * cost the least, and the refit rotates unbalanced ancestors so queries stay
+ * logarithmic under churn. When a large share of the leaves needs inserting at once,
+ * like the first frame or a mass spawn, the tree is instead rebuilt top-down by
+ * median splits, which gives much tighter boxes than one insert at a time.
+ *
+ * Unlike the grid it has no preferred object size, so it copes with bullets, small
+ * enemies and large enemies in the same scene. Nodes live in one vector and freed
+ * nodes go on a free list, like the EntityManager's slots.
+ */
+class DynamicAabbTree
+{
+    static constexpr int32_t Null = -1;
+
+    struct Node
+    {
+        Aabb           box;
+        CollisionProxy proxy;          ///< Current circle, leaves only
+        int32_t        parent = Null;
+        int32_t        left   = Null;  ///< Null for leaves
+        int32_t        right  = Null;
+        int32_t        height = 0;     ///< 0 for leaves
+        uint32_t       stamp  = 0;     ///< Last update() that saw this leaf
+
+        [[nodiscard]] bool isLeaf() const
+        {
+            return left == Null;
+        }
+    };
+
+    float                m_margin = 8.0f;
+    int32_t              m_root   = Null;
+    uint32_t             m_stamp  = 0;
+    std::vector<Node>    m_nodes;
+    std::vector<int32_t> m_freeNodes;
+    std::vector<int32_t> m_leaves;       ///< Every leaf currently in the tree
+    std::vector<int32_t> m_leafOfSlot;   ///< Leaf for each entity slot index, or Null
+    std::vector<int32_t> m_pending;      ///< Leaves waiting to be (re)inserted by update()
+    size_t               m_reinserted = 0;
+    mutable std::vector<int32_t> m_stack; ///< Traversal stack reused by query()
+
+    int32_t allocateNode();
+    void    freeNode(int32_t node);
+    void    insertLeaf(int32_t leaf);
+    void    removeLeaf(int32_t leaf);
+    void    refit(int32_t node);
+    int32_t balance(int32_t node);
+    int32_t rotateUp(int32_t node, int32_t child, int32_t other);
+    void    rebuild();
+    int32_t build(std::span<int32_t> leaves);
+
+public:
+    /// Rebuild instead of inserting when more than 1 / RebuildFraction of the leaves are pending
+    static constexpr size_t RebuildFraction = 4;
+
+    explicit DynamicAabbTree(float margin = 8.0f);
+
+    /**
+     * @brief Inserts, moves and removes leaves so the tree holds exactly these targets
+     *
+     * Targets whose circles still fit their fat box only have their stored circle
+     * refreshed.
+     */
+    void update(std::span<const CollisionProxy> targets);
+
+    /// Leaves reinserted by the last update(), a measure of how well the margin fits
+    [[nodiscard]] size_t reinserted() const
+    {
+        return m_reinserted;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_leaves.size();
+    }
+
+    /// Calls f(const CollisionProxy&) for every leaf whose fat box overlaps box
+    template <typename F>
+    void query(const Aabb& box, F&& f) const
+    {
+        if (m_root == Null) return;
+
+        m_stack.clear();
+        m_stack.push_back(m_root);
+        while (!m_stack.empty())
+        {
+            const Node& node = m_nodes[m_stack.back()];
+            m_stack.pop_back();
+            if (!node.box.overlaps(box)) continue;
+
+            if (node.isLeaf())
+            {
+                f(node.proxy);
+            }
+            else
+            {
+                m_stack.push_back(node.left);
+                m_stack.push_back(node.right);
+            }
+        }
+    }
+};
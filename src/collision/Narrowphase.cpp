@@ -0,0 +1,246 @@
+//
+// Created by Jorge Jimenez on 7/20/25.
+//
+
+#include "Narrowphase.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    /// Packed inputs of one batch, row i of each array describes pair i
+    struct Pairs
+    {
+        const float* ax; const float* ay; const float* ar;
+        const float* mx; const float* my;
+        const float* bx; const float* by; const float* br;
+    };
+
+    /// Keeps the closest-approach division finite for pairs that didn't move
+    constexpr float MinMotion = 1e-12f;
+
+    /*
+     * Every kernel finds the point of A's sweep closest to B, relative to B:
+     *
+     *   d0 = (a - b) - m                        offset at the start of the step
+     *   t  = clamp(-(d0 . m) / (m . m), 0, 1)   closest point along the sweep
+     *   hit when |d0 + t m|^2 < (ra + rb)^2
+     *
+     * With no motion t is 0 and this is the plain overlap test.
+     */
+    size_t overlapsScalar(const Pairs& p, const size_t begin, const size_t count, uint32_t* hits)
+    {
+        size_t n = 0;
+        for (size_t i = begin; i < count; i++)
+        {
+            const float d0x = (p.ax[i] - p.bx[i]) - p.mx[i];
+            const float d0y = (p.ay[i] - p.by[i]) - p.my[i];
+            const float mm  = p.mx[i] * p.mx[i] + p.my[i] * p.my[i];
+            const float dm  = d0x * p.mx[i] + d0y * p.my[i];
+            const float t   = std::min(std::max((0.0f - dm) / std::max(mm, MinMotion), 0.0f), 1.0f);
+            const float cx  = d0x + t * p.mx[i];
+            const float cy  = d0y + t * p.my[i];
+            const float r   = p.ar[i] + p.br[i];
+
+            // write unconditionally and only advance on a hit, so there's no branch
+            hits[n] = static_cast<uint32_t>(i);
+            n += cx * cx + cy * cy < r * r;
+        }
+        return n;
+    }
+
+#if SIMD_X86
+    /**
+     * @brief Lanes of the set bits of every 8-bit mask, packed low to high as nibbles
+     *
+     * Looking up the hit lanes and storing them all at once avoids looping over the
+     * bits of the compare mask, which mispredicts constantly since hits are random.
+     */
+    constexpr auto PackedLanes = [] {
+        std::array<uint32_t, 256> table{};
+        for (unsigned mask = 0; mask < 256; mask++)
+        {
+            unsigned n = 0;
+            for (unsigned lane = 0; lane < 8; lane++)
+            {
+                if (mask & (1u << lane)) table[mask] |= lane << (4 * n++);
+            }
+        }
+        return table;
+    }();
+
+    /// The first 16 PackedLanes entries unpacked to one lane per int, ready to load into SSE
+    alignas(16) constexpr auto SseLanes = [] {
+        std::array<std::array<uint32_t, 4>, 16> table{};
+        for (unsigned mask = 0; mask < 16; mask++)
+        {
+            for (unsigned lane = 0; lane < 4; lane++) table[mask][lane] = (PackedLanes[mask] >> (4 * lane)) & 0xf;
+        }
+        return table;
+    }();
+
+    SIMD_TARGET("sse2")
+    size_t overlapsSse(const Pairs& p, const size_t count, uint32_t* hits)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one  = _mm_set1_ps(1.0f);
+        const __m128 minMotion = _mm_set1_ps(MinMotion);
+
+        size_t n = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 mx  = _mm_loadu_ps(p.mx + i);
+            const __m128 my  = _mm_loadu_ps(p.my + i);
+            const __m128 d0x = _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(p.ax + i), _mm_loadu_ps(p.bx + i)), mx);
+            const __m128 d0y = _mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(p.ay + i), _mm_loadu_ps(p.by + i)), my);
+            const __m128 mm  = _mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my));
+            const __m128 dm  = _mm_add_ps(_mm_mul_ps(d0x, mx), _mm_mul_ps(d0y, my));
+            const __m128 t   = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(zero, dm), _mm_max_ps(mm, minMotion)), zero), one);
+            const __m128 cx  = _mm_add_ps(d0x, _mm_mul_ps(t, mx));
+            const __m128 cy  = _mm_add_ps(d0y, _mm_mul_ps(t, my));
+            const __m128 r   = _mm_add_ps(_mm_loadu_ps(p.ar + i), _mm_loadu_ps(p.br + i));
+            const __m128 d2  = _mm_add_ps(_mm_mul_ps(cx, cx), _mm_mul_ps(cy, cy));
+
+            const auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(d2, _mm_mul_ps(r, r))));
+            const __m128i lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(SseLanes[mask].data()));
+            const __m128i indices = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)), lanes);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + n), indices);
+            n += static_cast<size_t>(std::popcount(mask));
+        }
+        return n + overlapsScalar(p, i, count, hits + n);
+    }
+
+    SIMD_TARGET("avx2")
+    size_t overlapsAvx2(const Pairs& p, const size_t count, uint32_t* hits)
+    {
+        const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i nibble = _mm256_set1_epi32(0xf);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one  = _mm256_set1_ps(1.0f);
+        const __m256 minMotion = _mm256_set1_ps(MinMotion);
+
+        size_t n = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 mx  = _mm256_loadu_ps(p.mx + i);
+            const __m256 my  = _mm256_loadu_ps(p.my + i);
+            const __m256 d0x = _mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(p.ax + i), _mm256_loadu_ps(p.bx + i)), mx);
+            const __m256 d0y = _mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(p.ay + i), _mm256_loadu_ps(p.by + i)), my);
+            const __m256 mm  = _mm256_add_ps(_mm256_mul_ps(mx, mx), _mm256_mul_ps(my, my));
+            const __m256 dm  = _mm256_add_ps(_mm256_mul_ps(d0x, mx), _mm256_mul_ps(d0y, my));
+            const __m256 t   = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(_mm256_sub_ps(zero, dm), _mm256_max_ps(mm, minMotion)), zero), one);
+            const __m256 cx  = _mm256_add_ps(d0x, _mm256_mul_ps(t, mx));
+            const __m256 cy  = _mm256_add_ps(d0y, _mm256_mul_ps(t, my));
+            const __m256 r   = _mm256_add_ps(_mm256_loadu_ps(p.ar + i), _mm256_loadu_ps(p.br + i));
+            const __m256 d2  = _mm256_add_ps(_mm256_mul_ps(cx, cx), _mm256_mul_ps(cy, cy));
+
+            const __m256 inside = _mm256_cmp_ps(d2, _mm256_mul_ps(r, r), _CMP_LT_OQ);
+            const auto mask = static_cast<unsigned>(_mm256_movemask_ps(inside));
+
+            // unpack the hit lanes from the table and store all eight, only the hits count
+            const __m256i packed = _mm256_set1_epi32(static_cast<int>(PackedLanes[mask]));
+            const __m256i lanes = _mm256_and_si256(_mm256_srlv_epi32(packed, shifts), nibble);
+            const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lanes);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + n), indices);
+            n += static_cast<size_t>(std::popcount(mask));
+        }
+        return n + overlapsScalar(p, i, count, hits + n);
+    }
+
+    SIMD_TARGET("avx512f")
+    size_t overlapsAvx512(const Pairs& p, const size_t count, uint32_t* hits)
+    {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one  = _mm512_set1_ps(1.0f);
+        const __m512 minMotion = _mm512_set1_ps(MinMotion);
+
+        size_t n = 0;
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m512 mx  = _mm512_loadu_ps(p.mx + i);
+            const __m512 my  = _mm512_loadu_ps(p.my + i);
+            const __m512 d0x = _mm512_sub_ps(_mm512_sub_ps(_mm512_loadu_ps(p.ax + i), _mm512_loadu_ps(p.bx + i)), mx);
+            const __m512 d0y = _mm512_sub_ps(_mm512_sub_ps(_mm512_loadu_ps(p.ay + i), _mm512_loadu_ps(p.by + i)), my);
+            const __m512 mm  = _mm512_add_ps(_mm512_mul_ps(mx, mx), _mm512_mul_ps(my, my));
+            const __m512 dm  = _mm512_add_ps(_mm512_mul_ps(d0x, mx), _mm512_mul_ps(d0y, my));
+            const __m512 t   = _mm512_min_ps(_mm512_max_ps(_mm512_div_ps(_mm512_sub_ps(zero, dm), _mm512_max_ps(mm, minMotion)), zero), one);
+            const __m512 cx  = _mm512_add_ps(d0x, _mm512_mul_ps(t, mx));
+            const __m512 cy  = _mm512_add_ps(d0y, _mm512_mul_ps(t, my));
+            const __m512 r   = _mm512_add_ps(_mm512_loadu_ps(p.ar + i), _mm512_loadu_ps(p.br + i));
+            const __m512 d2  = _mm512_add_ps(_mm512_mul_ps(cx, cx), _mm512_mul_ps(cy, cy));
+
+            // compress-store writes the hit indices out with no per-bit loop
+            const __mmask16 inside = _mm512_cmp_ps_mask(d2, _mm512_mul_ps(r, r), _CMP_LT_OQ);
+            const __m512i indices = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(i)), lanes);
+            _mm512_mask_compressstoreu_epi32(hits + n, inside, indices);
+            n += static_cast<size_t>(std::popcount(static_cast<unsigned>(inside)));
+        }
+        return n + overlapsScalar(p, i, count, hits + n);
+    }
+#endif
+}
+
+void Narrowphase::clear()
+{
+    m_ax.clear(); m_ay.clear(); m_ar.clear();
+    m_mx.clear(); m_my.clear();
+    m_bx.clear(); m_by.clear(); m_br.clear();
+}
+
+void Narrowphase::add(const Vec2f posA, const float radiusA, const Vec2f posB, const float radiusB,
+                      const Vec2f motion)
+{
+    m_ax.push_back(posA.x); m_ay.push_back(posA.y); m_ar.push_back(radiusA);
+    m_mx.push_back(motion.x); m_my.push_back(motion.y);
+    m_bx.push_back(posB.x); m_by.push_back(posB.y); m_br.push_back(radiusB);
+}
+
+float Narrowphase::timeOfImpact(const uint32_t pair) const
+{
+    // solve |d0 + t m| = r for the first t, the sweep's entry into B
+    const float d0x = (m_ax[pair] - m_bx[pair]) - m_mx[pair];
+    const float d0y = (m_ay[pair] - m_by[pair]) - m_my[pair];
+    const float r   = m_ar[pair] + m_br[pair];
+
+    const float c = d0x * d0x + d0y * d0y - r * r;
+    if (c <= 0.0f) return 0.0f; // already touching at the start
+
+    const float a = m_mx[pair] * m_mx[pair] + m_my[pair] * m_my[pair];
+    const float b = d0x * m_mx[pair] + d0y * m_my[pair];
+    const float discriminant = b * b - a * c;
+    if (a <= 0.0f || discriminant < 0.0f) return 1.0f;
+
+    return std::clamp((-b - std::sqrt(discriminant)) / a, 0.0f, 1.0f);
+}
+
+std::span<const uint32_t> Narrowphase::run()
+{
+    const size_t count = size();
+    // kernels store a whole vector of indices at a time, past the last hit
+    m_hits.resize(std::max(m_hits.size(), count + 16));
+
+    const Pairs pairs{ m_ax.data(), m_ay.data(), m_ar.data(), m_mx.data(), m_my.data(),
+                       m_bx.data(), m_by.data(), m_br.data() };
+    size_t hits = 0;
+    switch (m_level)
+    {
+#if SIMD_X86
+        case SimdLevel::AVX512: hits = overlapsAvx512(pairs, count, m_hits.data()); break;
+        case SimdLevel::AVX2:   hits = overlapsAvx2(pairs, count, m_hits.data()); break;
+        case SimdLevel::SSE:    hits = overlapsSse(pairs, count, m_hits.data()); break;
+#endif
+        default:                hits = overlapsScalar(pairs, 0, count, m_hits.data()); break;
+    }
+    return { m_hits.data(), hits };
+}
+
+void Narrowphase::setLevel(const SimdLevel level)
+{
+    m_level = std::min(level, simdLevel());
+}
@@ -0,0 +1,77 @@
+//
+// Created by Jorge Jimenez on 7/20/25.
+//
+
+#pragma once
+
+#include "../simd/Simd.h"
+#include "../vec2/Vec2.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Batched circle-vs-circle overlap test over packed candidate pairs
+ *
+ * Pairs are appended into struct-of-arrays buffers (both centres and radii) and
+ * tested together, 4, 8 or 16 pairs per instruction depending on the widest
+ * instruction set the CPU supports. The result is a compact list with the index of
+ * every overlapping pair, in the order the pairs were added.
+ *
+ * Circle A can also be swept: given how far it moved this step, the pair hits if B
+ * touches any point of A's path, so fast bullets can't tunnel through small targets.
+ * timeOfImpact() then says how far along the path the contact starts.
+ *
+ * Every kernel runs the same operations in the same order without fused
+ * multiply-adds, so they all agree with the scalar kernel bit for bit.
+ *
+ * @example
+ * narrowphase.clear();
+ * for (const auto& [query, target] : pairs) {
+ *     narrowphase.add(bullets[query].pos, bullets[query].radius, target.pos, target.radius);
+ * }
+ * for (const uint32_t hit : narrowphase.run()) { ... pairs[hit] ... }
+ */
+class Narrowphase
+{
+    std::vector<float>    m_ax, m_ay, m_ar;
+    std::vector<float>    m_mx, m_my;   ///< A's motion over the step
+    std::vector<float>    m_bx, m_by, m_br;
+    std::vector<uint32_t> m_hits;
+    SimdLevel             m_level = simdLevel();
+
+public:
+    /// Removes every pair, keeping the buffers for the next frame
+    void clear();
+
+    /**
+     * @brief Adds a pair to the batch
+     *
+     * @param posA   Where A ended the step
+     * @param motion How far A moved this step. B is treated as still, at posB
+     */
+    void add(Vec2f posA, float radiusA, Vec2f posB, float radiusB, Vec2f motion = Vec2f(0, 0));
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_ax.size();
+    }
+
+    /**
+     * @brief Tests every pair added since clear()
+     *
+     * @return Indices of the overlapping pairs, valid until the next add() or run()
+     */
+    std::span<const uint32_t> run();
+
+    /// Fraction of A's motion at which it first touches B, for a pair run() reported
+    [[nodiscard]] float timeOfImpact(uint32_t pair) const;
+
+    [[nodiscard]] SimdLevel level() const
+    {
+        return m_level;
+    }
+
+    /// Forces a narrower kernel, for benchmarks. Levels the CPU lacks are clamped
+    void setLevel(SimdLevel level);
+};
@@ -0,0 +1,64 @@
+//
+// Created by Jorge Jimenez on 7/18/25.
+//
+
+#include "SpatialHash.h"
+#include <algorithm>
+#include <bit>
+
+SpatialHash::SpatialHash(const float cellSize)
+{
+    setCellSize(cellSize);
+}
+
+void SpatialHash::setCellSize(const float cellSize)
+{
+    m_cellSize    = std::max(cellSize, 1.0f);
+    m_inverseCell = 1.0f / m_cellSize;
+}
+
+void SpatialHash::rebuild(const std::span<const CollisionProxy> proxies)
+{
+    const size_t count = proxies.size();
+
+    // about two buckets per proxy keeps chains short without wasting memory
+    const size_t buckets = std::bit_ceil(std::max<size_t>(count * 2, 16));
+    m_bucketMask = static_cast<uint32_t>(buckets - 1);
+    m_bucketStart.assign(buckets + 1, 0);
+    m_proxyBucket.resize(count);
+    m_entryCell.resize(count);
+    m_entries.resize(count);
+    m_maxRadius = 0.0f;
+
+    // count proxies per bucket
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& proxy = proxies[i];
+        const uint32_t bucket = bucketOf(cellCoord(proxy.pos.x), cellCoord(proxy.pos.y));
+        m_proxyBucket[i] = bucket;
+        m_bucketStart[bucket + 1]++;
+        m_maxRadius = std::max(m_maxRadius, proxy.radius);
+    }
+
+    // prefix sum turns the counts into start offsets
+    for (size_t b = 0; b < buckets; b++)
+    {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+
+    // scatter, advancing each bucket start as its write cursor
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& proxy = proxies[i];
+        const uint32_t slot = m_bucketStart[m_proxyBucket[i]]++;
+        m_entries[slot]   = proxy;
+        m_entryCell[slot] = packCell(cellCoord(proxy.pos.x), cellCoord(proxy.pos.y));
+    }
+
+    // the scatter advanced every start to the next bucket's start, shift them back
+    for (size_t b = buckets; b > 0; b--)
+    {
+        m_bucketStart[b] = m_bucketStart[b - 1];
+    }
+    m_bucketStart[0] = 0;
+}
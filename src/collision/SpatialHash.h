@@ -0,0 +1,125 @@
+//
+// Created by Jorge Jimenez on 7/18/25.
+//
+
+#pragma once
+
+#include "../entity/Entity.h"
+#include "../vec2/Vec2.h"
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// A collidable circle as seen by the broadphase
+struct CollisionProxy
+{
+    EntityHandle entity;
+    Vec2f        pos;              ///< Position at the end of the step
+    float        radius = 0;
+    Vec2f        motion;           ///< Distance moved during the step, for swept queries
+};
+
+/**
+ * @brief Uniform-grid spatial hash over collision circles, rebuilt every frame
+ *
+ * Each proxy is binned by the cell containing its centre. Cells are hashed into a
+ * power-of-two bucket table and the proxies are counting-sorted by bucket, so a
+ * rebuild is two linear passes and a query only touches the handful of cells around
+ * the query circle. Queries are widened by the largest radius seen in the last
+ * rebuild, so no overlap is missed even when a proxy is larger than a cell.
+ *
+ * Works best with a cell size around the diameter of the typical proxy. All buffers
+ * are reused between rebuilds, so steady-state frames don't allocate.
+ *
+ * @example
+ * grid.rebuild(proxies);
+ * grid.query(bullet.pos, bullet.radius, [&](const CollisionProxy& target) {
+ *     // target's cell is near the bullet, still needs an exact circle test
+ * });
+ */
+class SpatialHash
+{
+    float                       m_cellSize    = 64.0f;
+    float                       m_inverseCell = 1.0f / 64.0f;
+    float                       m_maxRadius   = 0.0f;
+    uint32_t                    m_bucketMask  = 0;
+    std::vector<uint32_t>       m_bucketStart;  ///< Offset of each bucket's first entry, plus one end offset
+    std::vector<uint32_t>       m_proxyBucket;  ///< Scratch: bucket of every proxy passed to rebuild()
+    std::vector<uint64_t>       m_entryCell;    ///< Packed cell coordinates of each sorted entry
+    std::vector<CollisionProxy> m_entries;      ///< Proxies sorted by bucket
+
+    [[nodiscard]] int32_t cellCoord(const float v) const
+    {
+        return static_cast<int32_t>(std::floor(v * m_inverseCell));
+    }
+
+    [[nodiscard]] static uint64_t packCell(const int32_t cx, const int32_t cy)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    [[nodiscard]] uint32_t bucketOf(const int32_t cx, const int32_t cy) const
+    {
+        const uint32_t h = static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cy) * 19349663u;
+        return h & m_bucketMask;
+    }
+
+public:
+    explicit SpatialHash(float cellSize = 64.0f);
+
+    /// Sets the cell edge length, takes effect on the next rebuild()
+    void setCellSize(float cellSize);
+
+    [[nodiscard]] float cellSize() const
+    {
+        return m_cellSize;
+    }
+
+    /// Number of proxies in the last rebuild()
+    [[nodiscard]] size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    /// Replaces the contents of the grid with proxies
+    void rebuild(std::span<const CollisionProxy> proxies);
+
+    /**
+     * @brief Calls f(const CollisionProxy&) for every proxy whose cell is close enough
+     * to possibly overlap the circle at pos with the given radius
+     *
+     * Each proxy is reported at most once. Candidates still need an exact test.
+     */
+    template <typename F>
+    void query(const Vec2f pos, const float radius, F&& f) const
+    {
+        if (m_entries.empty()) return;
+
+        const float reach = radius + m_maxRadius;
+        const int32_t x0 = cellCoord(pos.x - reach), x1 = cellCoord(pos.x + reach);
+        const int32_t y0 = cellCoord(pos.y - reach), y1 = cellCoord(pos.y + reach);
+
+        // a query bigger than the whole grid is cheaper as a plain scan
+        const auto cells = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1);
+        if (cells > m_entries.size())
+        {
+            for (const auto& entry : m_entries) f(entry);
+            return;
+        }
+
+        for (int32_t cy = y0; cy <= y1; cy++)
+        {
+            for (int32_t cx = x0; cx <= x1; cx++)
+            {
+                const uint64_t cell = packCell(cx, cy);
+                const uint32_t bucket = bucketOf(cx, cy);
+                for (uint32_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1]; i++)
+                {
+                    // buckets are shared by every cell hashing to them
+                    if (m_entryCell[i] == cell) f(m_entries[i]);
+                }
+            }
+        }
+    }
+};
@@ -6,6 +6,8 @@
 
 #include "../vec2/Vec2.h"
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
 
 enum InterpolationType
 {
@@ -17,6 +19,19 @@ enum InterpolationType
     EASEINOUT_ELASTIC,
     EASEINOUT_EXPO,
     EASEIN_EXPO,
+    INTERPOLATION_COUNT
+};
+
+/// Display names, in the same order as InterpolationType
+inline constexpr const char* InterpolationTypeNames[] = {
+    "Ease Out Elastic",
+    "Ease Out Sine",
+    "Ease In Elastic",
+    "Ease In Sine",
+    "Ease In Out Sine",
+    "Ease In Out Elastic",
+    "Ease In Out Expo",
+    "Ease In Expo",
 };
 
 class Component
@@ -29,71 +44,97 @@ class CTransform : public Component
 {
 public:
     Vec2f pos       = { 0.0, 0.0};
-    Vec2f velocity  = { 0.0, 0.0};
-    float angle     = 0;
+    Vec2f prevPos   = { 0.0, 0.0};  // pos at the start of the current tick, for render interpolation
+    Vec2f velocity  = { 0.0, 0.0};  // per simulation tick
+    float angle     = 0;            // degrees
+    float prevAngle = 0;            // angle at the start of the current tick, for render interpolation
 
     CTransform() = default;
     CTransform(const Vec2f & p, const Vec2f & v, const float a)
-            : pos(p), velocity(v), angle(a) {}
+            : pos(p), prevPos(p), velocity(v), angle(a), prevAngle(a) {}
+
+    /// Moves without interpolating from the old position, for spawns and respawns
+    void teleport(const Vec2f & p)
+    {
+        pos = p;
+        prevPos = p;
+    }
 };
 
+/**
+ * @brief What an entity looks like: a regular polygon with a fill and an outline
+ *
+ * Only describes the shape. The geometry is built at draw time by the renderer from a
+ * unit polygon shared by every shape with the same point count, so a shape is a few
+ * plain fields that are cheap to create, copy and recycle.
+ */
 class CShape : public Component
 {
 public:
-    sf::CircleShape circle;
+    float     radius    = 0;
+    uint32_t  points    = 30;
+    sf::Color fill      = sf::Color::White;
+    sf::Color outline   = sf::Color::White;
+    float     thickness = 0;  // outline thickness, drawn outside the radius
 
     CShape() = default;
     CShape(const float radius, size_t points, const sf::Color & fill, const sf::Color & outline, const float thickness)
-    {
-        circle.setRadius(radius);
-        circle.setPointCount(points);
-        circle.setFillColor(fill);
-        circle.setOutlineColor(outline);
-        circle.setOutlineThickness(thickness);
-
-        // Set the origin to the center to radius, radius
-        const sf::Vector2f center = { radius, radius };
-        circle.setOrigin(center);
-    }
+        : radius(radius), points(static_cast<uint32_t>(points)), fill(fill), outline(outline), thickness(thickness) {}
 
     float getRadius() const
     {
-        return circle.getRadius();
+        return radius;
     }
 
     size_t getPointCount() const
     {
-        return circle.getPointCount();
+        return points;
+    }
+
+    void setRadius(const float r)
+    {
+        radius = r;
     }
 
     void setFillColor(const sf::Color color)
     {
-        circle.setFillColor(color);
+        fill = color;
     }
 
     void setOutlineColor(const sf::Color color)
     {
-        circle.setOutlineColor(color);
+        outline = color;
     }
 
     sf::Color getOutlineColor() const
     {
-        return circle.getOutlineColor();
+        return outline;
     }
     sf::Color getFillColor() const
     {
-        return circle.getFillColor();
+        return fill;
     }
 };
 
+// Collision layers, which pairs of layers collide is set by the CollisionMatrix
+enum CollisionLayer : uint8_t
+{
+    LAYER_BULLET,
+    LAYER_PLAYER,
+    LAYER_ENEMY,
+    LAYER_COUNT,
+};
+
 class CCollision : public Component
 {
 public:
-    float radius = 0;
+    float          radius = 0;
+    CollisionLayer layer  = LAYER_ENEMY;
+    bool           swept  = false;  // test along the whole per-step movement, for fast movers
 
     CCollision() = default;
-    explicit CCollision(const float r)
-        : radius(r) {}
+    explicit CCollision(const float r, const CollisionLayer l = LAYER_ENEMY, const bool s = false)
+        : radius(r), layer(l), swept(s) {}
 
 };
 
@@ -124,17 +165,32 @@ public:
         type(interpolationType){}
 };
 
+/**
+ * @brief Ticks an entity lives for, counted from the tick it was started on
+ *
+ * Nothing counts down per tick. The tick the entity expires on is stamped when the
+ * component is made and remaining() is worked out from the current tick whenever it
+ * is needed, so expiry can be scheduled ahead of time instead of checked on every
+ * entity every tick.
+ */
 class CLifespan : public Component
 {
     InterpolationType easeing = EASEIN_SINE;
 
 public:
     int lifespan = 0;
-    int remaining = 0;
+    int expiresAt = 0;  ///< Tick the entity expires on
 
     CLifespan() = default;
-    explicit CLifespan(const int totalLifespan)
-        : lifespan(totalLifespan), remaining(totalLifespan){}
+    /// Lives for totalLifespan ticks from startTick on
+    CLifespan(const int totalLifespan, const int startTick)
+        : lifespan(totalLifespan), expiresAt(startTick + totalLifespan){}
+
+    [[nodiscard]]
+    int remaining(const int now) const
+    {
+        return std::max(expiresAt - now, 0);
+    }
 
     void setEasingType(InterpolationType const type)
     {
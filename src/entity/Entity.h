@@ -1,11 +1,68 @@
 #pragma once
 
 #include "../components/Components.h"
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 class EntityManager;
 
+/**
+ * @brief Lightweight reference to an entity owned by the EntityManager
+ *
+ * A handle is a 32-bit slot index plus a 32-bit generation. When an entity is
+ * destroyed its slot is recycled and the generation is bumped, so any handle
+ * still pointing at the old occupant becomes stale instead of dangling. Handles
+ * are trivially copyable, so passing them around costs no refcount traffic.
+ *
+ * @example
+ * EntityHandle bullet = entityManager.addEntity("bullet");
+ * entityManager.add<CTransform>(bullet, Vec2f(100, 100), Vec2f(5, 0), 0.0f);
+ *
+ * // Later, after the bullet may have been destroyed
+ * if (entityManager.isAlive(bullet)) {
+ *     entityManager.get<CTransform>(bullet).pos.x += 5;
+ * }
+ */
+struct EntityHandle
+{
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index      = InvalidIndex; ///< Slot index inside the EntityManager
+    uint32_t generation = 0;            ///< Generation of the slot when the handle was issued
+
+    /**
+     * @brief Checks whether the handle was ever issued by an EntityManager
+     *
+     * This does not check whether the entity is still alive, use
+     * EntityManager::isAlive for that.
+     */
+    [[nodiscard]] bool valid() const
+    {
+        return index != InvalidIndex;
+    }
+
+    bool operator==(const EntityHandle& rhs) const = default;
+};
+
+using EntityVec = std::vector<EntityHandle>;
+
+/**
+ * @brief Small integer standing in for a tag string
+ *
+ * Tags are interned by the EntityManager when an entity is created, so comparing the
+ * tags of two entities is an integer compare and per-tag lists live in a flat array.
+ *
+ * @example
+ * const TagId bulletTag = entityManager.internTag("bullet");
+ * if (entityManager.tagId(e) == bulletTag) { ... }
+ */
+using TagId = uint16_t;
+
 /**
  * @brief Tuple containing all possible component types for an entity
  * 
@@ -22,6 +79,67 @@ using ComponentTuple = std::tuple<
     CSpazJump
 >;
 
+/// Display names for each component, in the same order as ComponentTuple
+inline constexpr const char* ComponentNames[] = {
+    "CTransform",
+    "CShape",
+    "CCollision",
+    "CInput",
+    "CScore",
+    "CLifespan",
+    "CSpazJump",
+};
+
+/**
+ * @brief Bitmask with one bit per ComponentTuple entry describing a set of components
+ */
+using Signature = uint32_t;
+
+static_assert(std::tuple_size_v<ComponentTuple> <= sizeof(Signature) * 8,
+              "Signature has fewer bits than there are component types");
+
+namespace detail
+{
+    template <typename T, typename Tuple>
+    struct TupleIndex;
+
+    template <typename T, typename... Ts>
+    struct TupleIndex<T, std::tuple<T, Ts...>> : std::integral_constant<size_t, 0> {};
+
+    template <typename T, typename U, typename... Ts>
+    struct TupleIndex<T, std::tuple<U, Ts...>>
+        : std::integral_constant<size_t, 1 + TupleIndex<T, std::tuple<Ts...>>::value> {};
+}
+
+/**
+ * @brief Position of a component type inside ComponentTuple, resolved at compile time
+ */
+template <typename T>
+inline constexpr size_t componentIndex = detail::TupleIndex<T, ComponentTuple>::value;
+
+/**
+ * @brief Signature bit of a single component type
+ *
+ * @example
+ * constexpr Signature movable = componentBit<CTransform>() | componentBit<CShape>();
+ */
+template <typename T>
+constexpr Signature componentBit()
+{
+    return Signature{1} << componentIndex<T>;
+}
+
+/**
+ * @brief Overwrites a component with a freshly constructed value and marks it existing
+ */
+template <typename T, typename... TArgs>
+T& assignComponent(T& component, TArgs&&... mArgs)
+{
+    component = T(std::forward<TArgs>(mArgs)...);
+    component.exists = true;
+    return component;
+}
+
 /**
  * @brief Entity class represents a game object with component-based architecture
  * 
@@ -29,18 +147,23 @@ using ComponentTuple = std::tuple<
  * identification, and can have different components attached to it that define
  * its behavior and properties. The entity itself has minimal behavior beyond 
  * managing its components and lifecycle.
+ *
+ * An Entity record only exists while the entity is being built: addEntity() stages
+ * one, components are added to it, and the next EntityManager::update() moves its
+ * components into the archetype matching its component set. Game code never sees
+ * the record itself and refers to entities through an EntityHandle.
  * 
  * @example
  * // Entities should be created through EntityManager
  * auto entity = entityManager.addEntity("player");
  * 
  * // Add components to the entity
- * entity->add<CTransform>(Vec2f(100, 100));
- * entity->add<CShape>(32, 8, sf::Color::Blue, sf::Color::Red, 2);
+ * entityManager.add<CTransform>(entity, Vec2f(100, 100), Vec2f(0, 0), 0.0f);
+ * entityManager.add<CShape>(entity, 32, 8, sf::Color::Blue, sf::Color::Red, 2);
  * 
  * // Check for components and use them
- * if (entity->has<CTransform>() && entity->has<CShape>()) {
- *     auto& transform = entity->get<CTransform>();
+ * if (entityManager.has<CTransform>(entity) && entityManager.has<CShape>(entity)) {
+ *     auto& transform = entityManager.get<CTransform>(entity);
  *     transform.pos.x += 10;
  * }
  */
@@ -50,21 +173,53 @@ class Entity
 
     ComponentTuple  components;     ///< Stores all components for this entity
     bool            active = true;  ///< Whether this entity is active in the game world
-    std::string     entityTag    = "dfault"; ///< Identifying tag for this entity type
+    TagId           entityTag    = 0;        ///< Interned tag identifying this entity type
     size_t          entityId     = 0;        ///< Unique identifier for this entity
 
+    /// Bitmask of the components that currently exist on this entity
+    [[nodiscard]] Signature signature() const
+    {
+        return signatureOf(std::make_index_sequence<std::tuple_size_v<ComponentTuple>>{});
+    }
+
+    template <size_t... Is>
+    [[nodiscard]] Signature signatureOf(std::index_sequence<Is...>) const
+    {
+        return ((std::get<Is>(components).exists ? Signature{1} << Is : Signature{0}) | ...);
+    }
+
+    template <size_t... Is>
+    void clearComponents(std::index_sequence<Is...>)
+    {
+        ((std::get<Is>(components).exists = false), ...);
+    }
+
+    /**
+     * @brief Reuses a pooled record for a new entity
+     *
+     * Components are only flagged as missing, not destroyed, so their storage is
+     * recycled by the next add().
+     */
+    void recycle(const size_t id, const TagId tag)
+    {
+        clearComponents(std::make_index_sequence<std::tuple_size_v<ComponentTuple>>{});
+        active    = true;
+        entityTag = tag;
+        entityId  = id;
+    }
+
     /**
      * @brief Constructor is private - entities should only be created via EntityManager
      * 
      * @param id Unique identifier assigned by EntityManager
-     * @param entityTag String tag for identifying entity type
+     * @param entityTag Interned tag for identifying entity type
      * 
      * @example
      * // Entities should not be constructed directly
      * auto entity = entityManager.addEntity("player"); // Correct way to create
      */
-    Entity(const size_t id, std::string entityTag)
-        : entityTag(std::move(entityTag)), entityId(id)
+    Entity(const size_t id, const TagId entityTag)
+        : entityTag(entityTag), entityId(id)
     {}
 
 public:
@@ -95,7 +250,7 @@ public:
      * 
      * @example
      * // Mark an entity for deletion when it's no longer needed
-     * if (bullet->get<CLifespan>().remaining <= 0) {
+     * if (bullet->get<CLifespan>().remaining(tick) <= 0) {
      *     bullet->destroy();  // Will be cleaned up by EntityManager
      * }
      */
@@ -125,21 +280,22 @@ public:
     }
 
     /**
-     * @brief Gets the tag string for this entity
+     * @brief Gets the interned tag for this entity
      * 
-     * The tag is useful for identifying the entity type (e.g., "player", "enemy")
+     * The tag is useful for identifying the entity type (e.g., "player", "enemy").
+     * EntityManager::tagName() turns it back into a string.
      * 
-     * @return const std::string& Reference to the entity's tag
+     * @return TagId The entity's tag
      * 
      * @example
      * // Use tag to identify entity type for game logic
-     * if (entity->tag() == "player") {
+     * if (entity->tag() == playerTag) {
      *     // Apply player-specific logic
-     * } else if (entity->tag() == "enemy") {
+     * } else if (entity->tag() == enemyTag) {
      *     // Apply enemy-specific logic
      * }
      */
-    [[nodiscard]] const std::string& tag() const
+    [[nodiscard]] TagId tag() const
     {
         return entityTag;
     }
@@ -190,10 +346,7 @@ public:
     template <typename T, typename... TArgs>
     T& add(TArgs&&... mArgs)
     {
-        auto& component = get<T>();
-        component = T(std::forward<TArgs>(mArgs)...);
-        component.exists = true;
-        return component;
+        return assignComponent(get<T>(), std::forward<TArgs>(mArgs)...);
     }
 
     /**
@@ -211,7 +364,7 @@ public:
      * 
      * // Access component properties
      * auto& shape = entity->get<CShape>();
-     * shape.circle.setFillColor(sf::Color::Green);
+     * shape.setFillColor(sf::Color::Green);
      */
     template<typename T>
     [[nodiscard]]
@@ -0,0 +1,279 @@
+//
+// Created by Jorge Jimenez on 6/15/25.
+//
+
+#pragma once
+
+#include "../entity/Entity.h"
+#include <cassert>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace detail
+{
+    template <typename Tuple>
+    struct ColumnTuple;
+
+    template <typename... Ts>
+    struct ColumnTuple<std::tuple<Ts...>>
+    {
+        using type = std::tuple<std::vector<Ts>...>;
+    };
+}
+
+/**
+ * @brief Struct-of-arrays storage for every entity sharing one exact component set
+ *
+ * Each component type in the archetype's signature gets its own contiguous column,
+ * so a system that only reads transforms walks a tightly packed std::vector<CTransform>
+ * instead of striding over whole entities. Columns for components outside the
+ * signature stay empty and never allocate. Row i of every column, plus entities()[i],
+ * describe the same entity.
+ *
+ * Rows double as a pool. Removing an entity swaps its row past the live rows instead
+ * of destroying it, and push() swaps new components into such a dead row, so component
+ * objects (and any buffers they own) are recycled rather than freed and reallocated.
+ * prewarm() constructs dead rows ahead of time.
+ *
+ * @example
+ * for (auto& archetype : entityManager.getArchetypes()) {
+ *     if (!archetype.has<CTransform>()) continue;
+ *     for (auto& transform : archetype.column<CTransform>()) {
+ *         transform.pos += transform.velocity;
+ *     }
+ * }
+ */
+class Archetype
+{
+    using Columns = detail::ColumnTuple<ComponentTuple>::type;
+    static constexpr size_t ComponentCount = std::tuple_size_v<ComponentTuple>;
+
+    Signature   componentMask = 0;
+    Columns     columns;
+    EntityVec   rowEntities;        ///< Handle stored in each live row
+    size_t      constructedRows = 0; ///< Live rows plus recyclable dead rows in every column
+    size_t      rowAllocations  = 0; ///< Times any column had to grow its heap buffer
+
+    [[nodiscard]] static constexpr bool inMask(const Signature mask, const size_t index)
+    {
+        return (mask & (Signature{1} << index)) != 0;
+    }
+
+    template <size_t... Is>
+    void pushRow(ComponentTuple& components, std::index_sequence<Is...>)
+    {
+        ((inMask(componentMask, Is)
+            ? pushInto(std::get<Is>(columns), std::get<Is>(components))
+            : void()), ...);
+    }
+
+    template <typename T>
+    void pushInto(std::vector<T>& column, T& component)
+    {
+        const size_t capacity = column.capacity();
+        column.push_back(std::move(component));
+        if (column.capacity() != capacity) rowAllocations++;
+    }
+
+    template <size_t... Is>
+    void swapIntoRow(const size_t row, ComponentTuple& components, std::index_sequence<Is...>)
+    {
+        using std::swap;
+        ((inMask(componentMask, Is)
+            ? swap(std::get<Is>(columns)[row], std::get<Is>(components))
+            : void()), ...);
+    }
+
+    template <size_t... Is>
+    void swapRows(const size_t a, const size_t b, std::index_sequence<Is...>)
+    {
+        using std::swap;
+        ((inMask(componentMask, Is)
+            ? swap(std::get<Is>(columns)[a], std::get<Is>(columns)[b])
+            : void()), ...);
+    }
+
+    template <size_t... Is>
+    void resizeColumns(const size_t rows, std::index_sequence<Is...>)
+    {
+        ((inMask(componentMask, Is)
+            ? std::get<Is>(columns).resize(rows)
+            : void()), ...);
+    }
+
+    template <size_t... Is>
+    void extractRow(const size_t row, ComponentTuple& out, std::index_sequence<Is...>)
+    {
+        ((inMask(componentMask, Is)
+            ? void(std::get<Is>(out) = std::move(std::get<Is>(columns)[row]))
+            : void()), ...);
+    }
+
+    template <size_t... Is>
+    static constexpr size_t bytesFor(const Signature mask, std::index_sequence<Is...>)
+    {
+        return ((inMask(mask, Is) ? sizeof(std::tuple_element_t<Is, ComponentTuple>) : 0) + ... + 0);
+    }
+
+public:
+    explicit Archetype(const Signature mask)
+        : componentMask(mask)
+    {}
+
+    [[nodiscard]] Signature signature() const
+    {
+        return componentMask;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return rowEntities.size();
+    }
+
+    /// Handles of the entities stored in this archetype, one per row
+    [[nodiscard]] const EntityVec& entities() const
+    {
+        return rowEntities;
+    }
+
+    template <typename T>
+    [[nodiscard]] bool has() const
+    {
+        return (componentMask & componentBit<T>()) != 0;
+    }
+
+    /**
+     * @brief Contiguous column holding component T for every live row
+     *
+     * Only valid for components in the archetype's signature.
+     */
+    template <typename T>
+    [[nodiscard]] std::span<T> column()
+    {
+        assert(has<T>() && "component is not part of this archetype");
+        return std::span<T>(std::get<std::vector<T>>(columns).data(), size());
+    }
+
+    template <typename T>
+    [[nodiscard]] std::span<const T> column() const
+    {
+        assert(has<T>() && "component is not part of this archetype");
+        return std::span<const T>(std::get<std::vector<T>>(columns).data(), size());
+    }
+
+    /**
+     * @brief Appends an entity, taking only the components named by the signature
+     *
+     * When a dead row is available its components are swapped with the incoming ones,
+     * so components hands back recycled objects rather than moved-from husks.
+     *
+     * @return The row the entity was stored in
+     */
+    uint32_t push(const EntityHandle entity, ComponentTuple& components)
+    {
+        const size_t row = size();
+        if (row < constructedRows)
+        {
+            swapIntoRow(row, components, std::make_index_sequence<ComponentCount>{});
+        }
+        else
+        {
+            pushRow(components, std::make_index_sequence<ComponentCount>{});
+            constructedRows++;
+        }
+
+        const size_t capacity = rowEntities.capacity();
+        rowEntities.push_back(entity);
+        if (rowEntities.capacity() != capacity) rowAllocations++;
+        return static_cast<uint32_t>(row);
+    }
+
+    /**
+     * @brief Constructs dead rows up front so the first rows pushed don't allocate
+     */
+    void prewarm(const size_t rows)
+    {
+        if (rows <= constructedRows) return;
+
+        resizeColumns(rows, std::make_index_sequence<ComponentCount>{});
+        rowEntities.reserve(rows);
+        constructedRows = rows;
+        rowAllocations++;
+    }
+
+    /// Live rows plus dead rows ready to be recycled
+    [[nodiscard]] size_t capacity() const
+    {
+        return constructedRows;
+    }
+
+    /// Number of times this archetype had to grow a heap buffer
+    [[nodiscard]] size_t allocations() const
+    {
+        return rowAllocations;
+    }
+
+    /**
+     * @brief Moves the components of a row out into a full ComponentTuple
+     *
+     * Components outside the signature are left untouched in out. The row itself is
+     * not removed, call swapRemove() afterwards.
+     */
+    void extract(const size_t row, ComponentTuple& out)
+    {
+        extractRow(row, out, std::make_index_sequence<ComponentCount>{});
+    }
+
+    /**
+     * @brief Removes a row by swapping it with the last live row
+     *
+     * The removed row's components stay constructed past the live rows for reuse.
+     *
+     * @return The handle of the entity that now occupies row, or an invalid handle
+     *         if the removed row was the last one
+     */
+    EntityHandle swapRemove(const size_t row)
+    {
+        const size_t last = size() - 1;
+        EntityHandle moved;
+        if (row != last)
+        {
+            swapRows(row, last, std::make_index_sequence<ComponentCount>{});
+            rowEntities[row] = rowEntities[last];
+            moved = rowEntities[row];
+        }
+        rowEntities.pop_back();
+        return moved;
+    }
+
+    /**
+     * @brief Removes every row whose entity fails keep(), preserving the order of the rest
+     *
+     * onMove(entity, newRow) is called for every surviving entity whose row changed.
+     */
+    template <typename Keep, typename OnMove>
+    void compact(Keep&& keep, OnMove&& onMove)
+    {
+        size_t write = 0;
+        for (size_t read = 0; read < rowEntities.size(); read++)
+        {
+            if (!keep(rowEntities[read])) continue;
+
+            if (write != read)
+            {
+                swapRows(read, write, std::make_index_sequence<ComponentCount>{});
+                rowEntities[write] = rowEntities[read];
+                onMove(rowEntities[write], static_cast<uint32_t>(write));
+            }
+            write++;
+        }
+        rowEntities.resize(write);
+    }
+
+    /// Bytes of component data plus the row's handle stored for each entity
+    [[nodiscard]] size_t bytesPerEntity() const
+    {
+        return bytesFor(componentMask, std::make_index_sequence<ComponentCount>{}) + sizeof(EntityHandle);
+    }
+};
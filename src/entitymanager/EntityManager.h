@@ -5,91 +5,629 @@
 #pragma once
 
 #include "../entity/Entity.h"
+#include "Archetype.h"
+#include "View.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <string>
+#include <unordered_map>
 #include <vector>
-#include <map>
-#include <memory>
-
-using EntityVec = std::vector<std::shared_ptr<Entity>>;
 
 
+/**
+ * @brief Owns every entity in the game and hands out generational handles to them
+ *
+ * Entities are addressed through a slot map. Each slot remembers the generation of
+ * its current occupant and which archetype row holds that occupant's components,
+ * so resolving a handle is two array lookups and validating one is a single compare.
+ * Freed slots are recycled through a free list.
+ *
+ * Component data lives in archetypes: one struct-of-arrays table per distinct
+ * component set, so a bullet only pays for the components it actually has and
+ * systems can stream the columns they need through view<Ts...>().
+ *
+ * Tags are interned to TagIds on creation. Each tag has a bucket in a flat,
+ * TagId-indexed table.
+ *
+ * destroy() only queues the entity. update() then removes each queued entity from
+ * its archetype, the entity list and its tag bucket by swapping the last entry into
+ * its place, so the cost of a frame's cleanup is proportional to the number of
+ * deaths, not to the number of entities. Swapping reorders survivors; call
+ * setPreserveOrder(true) if something depends on iteration order, at the price of
+ * compacting every container that lost an entity.
+ *
+ * Everything is pooled so bullet and enemy churn stops hitting the allocator: slots
+ * come back through a free list, staging records are reused, dead archetype rows keep
+ * their component objects for the next entity, and lists keep their capacity.
+ * reserve() pre-warms the pools and poolStats() counts every buffer growth, which
+ * should stay flat once a game reaches a steady state.
+ *
+ * Entities created during a frame are staged and only become visible to
+ * getEntities() after the next update(), which keeps iteration safe while systems
+ * spawn new entities. Staging also means an entity built with several add<T>() calls
+ * is moved into its archetype once, not once per component.
+ *
+ * @example
+ * EntityManager entities;
+ * auto player = entities.addEntity("player");
+ * entities.add<CTransform>(player, Vec2f(100, 100), Vec2f(0, 0), 0.0f);
+ * entities.update(); // player is now part of getEntities()
+ *
+ * entities.view<CTransform>().each([](CTransform& transform) {
+ *     transform.pos.x += 1;
+ * });
+ */
 class EntityManager
 {
+    /// Per-slot bookkeeping, indexed by EntityHandle::index
+    struct Slot
+    {
+        uint32_t    generation = 0;                          ///< Generation of the current occupant
+        uint32_t    location   = EntityHandle::InvalidIndex; ///< Archetype row, or staged index while staged
+        uint32_t    archetype  = 0;                          ///< Index into archetypes once committed
+        bool        staged     = false;                      ///< True until the next update() commits it
+        bool        alive      = false;                      ///< Cleared by destroy() on committed entities
+        size_t      id         = 0;                          ///< Unique id shown in the GUI
+        TagId       tag        = 0;                          ///< Interned tag
+        uint32_t    tagPosition = 0;                         ///< Position in tagIndex[tag] once committed
+        uint32_t    listPosition = 0;                        ///< Position in entitiesList once committed
+    };
+
+    std::vector<Slot>                   slots;
+    std::vector<uint32_t>               freeSlots;
+    std::deque<Archetype>               archetypes;        ///< deque keeps references stable while growing
+    std::unordered_map<Signature, uint32_t> archetypeLookup;
     EntityVec                           entitiesList;
+    std::vector<Entity>                 entitiesToAddData; ///< Pooled staging records, the first entitiesToAdd.size() are in use
     EntityVec                           entitiesToAdd;
-    std::map<std::string, EntityVec>    entityMap;
+    EntityVec                           entitiesToDestroy; ///< Committed entities destroyed since the last update()
+    std::vector<EntityVec>              tagIndex;          ///< Committed entities per tag, indexed by TagId
+    std::vector<std::string>            tagNames;          ///< Tag strings, indexed by TagId
+    std::unordered_map<std::string, TagId> tagLookup;
     size_t                              totalEntities = 0;
+    bool                                preserveOrder = false;
+    size_t                              prewarmRows   = 0;   ///< Rows constructed in each new archetype
+    size_t                              allocations   = 0;   ///< Buffer growths outside the archetypes
+    size_t                              slotsRecycled = 0;
+    size_t                              recordsRecycled = 0;
+
+    /// push_back that counts the vector's buffer growths towards poolStats()
+    template <typename V, typename... TArgs>
+    void pushCounted(V& vec, TArgs&&... mArgs)
+    {
+        const size_t capacity = vec.capacity();
+        vec.emplace_back(std::forward<TArgs>(mArgs)...);
+        if (vec.capacity() != capacity) allocations++;
+    }
 
-    static void removeDeadEntities(EntityVec& vec)
+    /// Swap-and-pop an entity out of a list that it knows its position in
+    void swapRemove(EntityVec& vec, const EntityHandle entity, uint32_t Slot::* position)
+    {
+        const uint32_t index = slots[entity.index].*position;
+        const EntityHandle last = vec.back();
+        vec[index] = last;
+        slots[last.index].*position = index;
+        vec.pop_back();
+    }
+
+    /// Removes dead entities keeping the order of the rest, and refreshes their positions
+    void removeDeadEntities(EntityVec& vec, uint32_t Slot::* position)
     {
         vec.erase(
             std::remove_if(vec.begin(), vec.end(),
-               [](const auto& entity) {
-                   return !entity->isActive();
+               [this](const auto& entity) {
+                   return !slots[entity.index].alive;
                }),
             vec.end()
         );
+
+        for (size_t i = 0; i < vec.size(); i++)
+        {
+            slots[vec[i].index].*position = static_cast<uint32_t>(i);
+        }
+    }
+
+    /// O(deaths): swap the last entry of every container into each dead entity's place
+    void destroyQueuedUnordered()
+    {
+        for (const auto e : entitiesToDestroy)
+        {
+            const Slot& slot = slots[e.index];
+            swapRemove(entitiesList, e, &Slot::listPosition);
+            swapRemove(tagIndex[slot.tag], e, &Slot::tagPosition);
+
+            if (const EntityHandle moved = archetypes[slot.archetype].swapRemove(slot.location); moved.valid())
+            {
+                slots[moved.index].location = slot.location;
+            }
+
+            releaseSlot(e.index);
+        }
+    }
+
+    /// Compacts only the containers that lost an entity, preserving iteration order
+    void destroyQueuedOrdered()
+    {
+        std::vector<bool> touchedArchetypes(archetypes.size(), false);
+        std::vector<bool> touchedTags(tagIndex.size(), false);
+        for (const auto e : entitiesToDestroy)
+        {
+            touchedArchetypes[slots[e.index].archetype] = true;
+            touchedTags[slots[e.index].tag] = true;
+        }
+
+        removeDeadEntities(entitiesList, &Slot::listPosition);
+        for (size_t tag = 0; tag < tagIndex.size(); tag++)
+        {
+            if (touchedTags[tag]) removeDeadEntities(tagIndex[tag], &Slot::tagPosition);
+        }
+        for (size_t i = 0; i < archetypes.size(); i++)
+        {
+            if (!touchedArchetypes[i]) continue;
+            archetypes[i].compact(
+                [this](const EntityHandle e) { return slots[e.index].alive; },
+                [this](const EntityHandle e, const uint32_t row) { slots[e.index].location = row; });
+        }
+
+        for (const auto e : entitiesToDestroy)
+        {
+            releaseSlot(e.index);
+        }
+    }
+
+    [[nodiscard]] Entity& staged(const EntityHandle entity)
+    {
+        return entitiesToAddData[slots[entity.index].location];
+    }
+
+    [[nodiscard]] const Entity& staged(const EntityHandle entity) const
+    {
+        return entitiesToAddData[slots[entity.index].location];
+    }
+
+    /// True if the handle still refers to the slot's current occupant
+    [[nodiscard]] bool isValid(const EntityHandle entity) const
+    {
+        return entity.index < slots.size() && slots[entity.index].generation == entity.generation
+            && slots[entity.index].location != EntityHandle::InvalidIndex;
+    }
+
+    uint32_t archetypeFor(const Signature signature)
+    {
+        if (const auto it = archetypeLookup.find(signature); it != archetypeLookup.end())
+        {
+            return it->second;
+        }
+
+        const auto index = static_cast<uint32_t>(archetypes.size());
+        archetypes.emplace_back(signature);
+        archetypes.back().prewarm(prewarmRows);
+        archetypeLookup.emplace(signature, index);
+        allocations++;
+        return index;
+    }
+
+    /**
+     * @brief Moves a committed entity into the archetype for newSignature
+     *
+     * mutate(components) runs on the entity's full component tuple between leaving the
+     * old archetype and entering the new one.
+     */
+    template <typename Mutate>
+    void migrate(const EntityHandle entity, const Signature newSignature, Mutate&& mutate)
+    {
+        Slot& slot = slots[entity.index];
+        Archetype& from = archetypes[slot.archetype];
+
+        ComponentTuple components;
+        from.extract(slot.location, components);
+        if (const EntityHandle moved = from.swapRemove(slot.location); moved.valid())
+        {
+            slots[moved.index].location = slot.location;
+        }
+
+        mutate(components);
+
+        slot.archetype = archetypeFor(newSignature);
+        slot.location  = archetypes[slot.archetype].push(entity, components);
+    }
+
+    void releaseSlot(const uint32_t index)
+    {
+        Slot& slot = slots[index];
+        slot.generation++;
+        slot.location = EntityHandle::InvalidIndex;
+        slot.staged   = false;
+        slot.alive    = false;
+        pushCounted(freeSlots, index);
     }
 
 public:
+    /// Component footprint of one archetype, as reported by memoryReport()
+    struct ArchetypeMemory
+    {
+        Signature signature      = 0;
+        size_t    entities       = 0;
+        size_t    bytesPerEntity = 0;
+    };
+
+    /// Pool counters, as reported by poolStats()
+    struct PoolStats
+    {
+        size_t heapAllocations = 0; ///< Buffer growths across every pool, archetype columns included
+        size_t slotsRecycled   = 0; ///< Slots reused from the free list
+        size_t recordsRecycled = 0; ///< Staging records reused
+        size_t pooledRows      = 0; ///< Dead archetype rows waiting to be reused
+    };
+
+    /// Staging records pre-warmed by reserve(), enough for a busy frame's spawns
+    static constexpr size_t MaxPrewarmedRecords = 256;
+
+    /// Bytes an entity holding one of every current component takes, the ceiling for any archetype
+    static constexpr size_t AllComponentsBytesPerEntity = sizeof(ComponentTuple) + sizeof(EntityHandle);
+
      EntityManager() = default;
+
+     /**
+      * @brief Removes entities destroyed since the last call and commits staged ones
+      *
+      * Should be called once per frame before any system runs. Costs O(destroyed +
+      * added) unless setPreserveOrder(true) was called.
+      */
      void update()
      {
-        for (const auto& e : entitiesToAdd)
+         if (!entitiesToDestroy.empty())
+         {
+             if (preserveOrder) destroyQueuedOrdered();
+             else destroyQueuedUnordered();
+             entitiesToDestroy.clear();
+         }
+
+        for (size_t i = 0; i < entitiesToAdd.size(); i++)
         {
-            entitiesList.push_back(e);
-            // entityMap[e->tag()].push_back(e);
-            // add it to the entity map
-            if (entityMap.find(e->tag()) == entityMap.end())
+            const EntityHandle e = entitiesToAdd[i];
+            Entity& data = entitiesToAddData[i];
+
+            // destroyed before it was ever committed
+            if (!data.isActive())
             {
-                entityMap[e->tag()] = EntityVec();
+                releaseSlot(e.index);
+                continue;
             }
 
-            entityMap[e->tag()].push_back(e);
+            Slot& slot = slots[e.index];
+            slot.archetype    = archetypeFor(data.signature());
+            slot.location     = archetypes[slot.archetype].push(e, data.components);
+            slot.staged       = false;
+            slot.listPosition = static_cast<uint32_t>(entitiesList.size());
+            slot.tagPosition  = static_cast<uint32_t>(tagIndex[slot.tag].size());
+
+            pushCounted(entitiesList, e);
+            pushCounted(tagIndex[slot.tag], e);
         }
 
+         // staging records stay constructed for the next frame's spawns
          entitiesToAdd.clear();
+     }
 
-         // remove dead entities from the vector of all entities
-         removeDeadEntities(entitiesList);
+    /**
+     * @brief Pre-warms the pools for a world of about `entities` live entities
+     *
+     * Reserves slots and lists, constructs `entities` recyclable rows in every
+     * archetype (including ones created later) and up to MaxPrewarmedRecords staging
+     * records.
+     */
+    void reserve(const size_t entities)
+    {
+        prewarmRows = entities;
 
-         // remove dead entities from each vector in the entity map
-         // c++20 way of iterating through [key, value] pairs in a map
-         for (auto& [tag, entityVec] : entityMap)
-         {
-             removeDeadEntities(entityVec);
-         }
-     }
+        slots.reserve(entities);
+        freeSlots.reserve(entities);
+        entitiesList.reserve(entities);
+        entitiesToDestroy.reserve(entities);
+        for (auto& bucket : tagIndex) bucket.reserve(entities);
+        for (auto& archetype : archetypes) archetype.prewarm(entities);
 
-    std::shared_ptr<Entity> addEntity(const std::string& tag)
+        const size_t records = std::min(entities, MaxPrewarmedRecords);
+        entitiesToAdd.reserve(records);
+        entitiesToAddData.reserve(records);
+        while (entitiesToAddData.size() < records)
+        {
+            entitiesToAddData.push_back(Entity(0, 0));
+        }
+        allocations++;
+    }
+
+    [[nodiscard]] PoolStats poolStats() const
     {
-        //create the entity shared pointer
-        auto entity = std::shared_ptr<Entity>(new Entity(totalEntities++, tag));
-        // can't use the statement below because of private constructor in Entity class
-        // auto entity = std::make_shared<Entity>(totalEntities++, tag);
+        PoolStats stats;
+        stats.heapAllocations = allocations;
+        stats.slotsRecycled   = slotsRecycled;
+        stats.recordsRecycled = recordsRecycled;
+        for (const auto& archetype : archetypes)
+        {
+            stats.heapAllocations += archetype.allocations();
+            stats.pooledRows      += archetype.capacity() - archetype.size();
+        }
+        return stats;
+    }
 
-        // add it to the vec of all entities
-        entitiesToAdd.push_back(entity);
+    /**
+     * @brief Chooses whether update() keeps the iteration order of surviving entities
+     *
+     * Off by default. When on, removing entities compacts every archetype, tag bucket
+     * and the entity list that lost one, instead of swapping the last entry into the
+     * hole.
+     */
+    void setPreserveOrder(const bool preserve)
+    {
+        preserveOrder = preserve;
+    }
+
+    [[nodiscard]] bool preservesOrder() const
+    {
+        return preserveOrder;
+    }
+
+    /**
+     * @brief Returns the TagId for a tag string, registering it on first use
+     */
+    TagId internTag(const std::string& tag)
+    {
+        if (const auto it = tagLookup.find(tag); it != tagLookup.end())
+        {
+            return it->second;
+        }
+
+        const auto id = static_cast<TagId>(tagNames.size());
+        tagNames.push_back(tag);
+        tagIndex.emplace_back();
+        tagIndex.back().reserve(prewarmRows);
+        tagLookup.emplace(tag, id);
+        return id;
+    }
+
+    [[nodiscard]] const std::string& tagName(const TagId tag) const
+    {
+        return tagNames[tag];
+    }
+
+    /**
+     * @brief Creates a new entity and returns a handle to it
+     *
+     * The entity can have components added right away, but it is only returned by
+     * getEntities() after the next update().
+     */
+    EntityHandle addEntity(const std::string& tag)
+    {
+        return addEntity(internTag(tag));
+    }
+
+    EntityHandle addEntity(const TagId tag)
+    {
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+            slotsRecycled++;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(slots.size());
+            pushCounted(slots);
+        }
+
+        Slot& slot = slots[index];
+        slot.location = static_cast<uint32_t>(entitiesToAdd.size());
+        slot.staged   = true;
+        slot.alive    = true;
+        slot.id       = totalEntities;
+        slot.tag      = tag;
+
+        const EntityHandle entity{ index, slot.generation };
+        if (entitiesToAdd.size() < entitiesToAddData.size())
+        {
+            entitiesToAddData[entitiesToAdd.size()].recycle(totalEntities++, tag);
+            recordsRecycled++;
+        }
+        else
+        {
+            pushCounted(entitiesToAddData, Entity(totalEntities++, tag));
+        }
+        pushCounted(entitiesToAdd, entity);
 
         return entity;
     }
 
+    /**
+     * @brief Checks that the handle refers to an entity that exists and has not been destroyed
+     */
+    [[nodiscard]] bool isAlive(const EntityHandle entity) const
+    {
+        if (!isValid(entity)) return false;
+        return slots[entity.index].staged ? staged(entity).isActive() : slots[entity.index].alive;
+    }
+
+    /**
+     * @brief Queues an entity for removal during the next update()
+     *
+     * The entity stops being alive immediately but its components stay readable until
+     * then. Destroying an entity twice is harmless.
+     */
+    void destroy(const EntityHandle entity)
+    {
+        if (!isAlive(entity)) return;
+
+        Slot& slot = slots[entity.index];
+        if (slot.staged)
+        {
+            staged(entity).destroy();
+            return;
+        }
+
+        slot.alive = false;
+        pushCounted(entitiesToDestroy, entity);
+    }
+
+    [[nodiscard]] size_t id(const EntityHandle entity) const
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        return slots[entity.index].id;
+    }
+
+    [[nodiscard]] TagId tagId(const EntityHandle entity) const
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        return slots[entity.index].tag;
+    }
+
+    [[nodiscard]] const std::string& tag(const EntityHandle entity) const
+    {
+        return tagName(tagId(entity));
+    }
+
+    template <typename T>
+    [[nodiscard]] bool has(const EntityHandle entity) const
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        const Slot& slot = slots[entity.index];
+        return slot.staged ? staged(entity).has<T>() : archetypes[slot.archetype].has<T>();
+    }
+
+    /**
+     * @brief Adds or replaces a component
+     *
+     * Adding a component a committed entity does not have yet moves the entity to
+     * another archetype, so prefer adding components right after addEntity().
+     */
+    template <typename T, typename... TArgs>
+    T& add(const EntityHandle entity, TArgs&&... mArgs)
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        const Slot& slot = slots[entity.index];
+        if (slot.staged) return staged(entity).add<T>(std::forward<TArgs>(mArgs)...);
+
+        if (Archetype& archetype = archetypes[slot.archetype]; archetype.has<T>())
+        {
+            return assignComponent(archetype.column<T>()[slot.location], std::forward<TArgs>(mArgs)...);
+        }
+
+        migrate(entity, archetypes[slot.archetype].signature() | componentBit<T>(),
+            [&](ComponentTuple& components) {
+                assignComponent(std::get<T>(components), std::forward<TArgs>(mArgs)...);
+            });
+        return get<T>(entity);
+    }
+
+    template <typename T>
+    [[nodiscard]] T& get(const EntityHandle entity)
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        const Slot& slot = slots[entity.index];
+        return slot.staged ? staged(entity).get<T>() : archetypes[slot.archetype].column<T>()[slot.location];
+    }
+
+    template <typename T>
+    [[nodiscard]] const T& get(const EntityHandle entity) const
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        const Slot& slot = slots[entity.index];
+        return slot.staged ? staged(entity).get<T>() : archetypes[slot.archetype].column<T>()[slot.location];
+    }
+
+    /**
+     * @brief Component of a live entity, or nullptr if the entity is gone or lacks it
+     *
+     * One slot lookup instead of isAlive(), has() and get() each doing their own, for
+     * systems that hold handles to entities that may have died since.
+     */
+    template <typename T>
+    [[nodiscard]] T* find(const EntityHandle entity)
+    {
+        if (!isAlive(entity)) return nullptr;
+
+        const Slot& slot = slots[entity.index];
+        if (slot.staged)
+        {
+            Entity& data = staged(entity);
+            return data.has<T>() ? &data.get<T>() : nullptr;
+        }
+
+        Archetype& archetype = archetypes[slot.archetype];
+        return archetype.has<T>() ? &archetype.column<T>()[slot.location] : nullptr;
+    }
+
+    template <typename T>
+    void remove(const EntityHandle entity)
+    {
+        assert(isValid(entity) && "stale or invalid EntityHandle");
+        const Slot& slot = slots[entity.index];
+        if (slot.staged)
+        {
+            staged(entity).remove<T>();
+            return;
+        }
+
+        if (!archetypes[slot.archetype].has<T>()) return;
+        migrate(entity, archetypes[slot.archetype].signature() & ~componentBit<T>(),
+            [](ComponentTuple& components) { std::get<T>(components) = T(); });
+    }
+
     const EntityVec& getEntities()
     {
         return entitiesList;
     }
 
+    const EntityVec& getEntities(const TagId tag)
+    {
+        return tagIndex[tag];
+    }
+
+    /**
+     * @brief Entities with the given tag, or an empty list for a tag never seen before
+     */
     const EntityVec& getEntities(const std::string& tag)
     {
-        if (entityMap.find(tag) == entityMap.end())
-        {
-            entityMap[tag] = EntityVec();
-        }
+        static const EntityVec empty;
+        const auto it = tagLookup.find(tag);
+        return it == tagLookup.end() ? empty : tagIndex[it->second];
+    }
+
+    /**
+     * @brief Typed query over every entity that has all of the components Ts...
+     *
+     * @example
+     * entities.view<CTransform, CShape>().each([](CTransform& t, CShape& s) { ... });
+     */
+    template <typename... Ts>
+    [[nodiscard]] View<Ts...> view()
+    {
+        return View<Ts...>(archetypes);
+    }
 
-        return entityMap[tag];
+    /**
+     * @brief Component tables, one per distinct component set
+     *
+     * Rows of destroyed entities stay in place until the next update(), check
+     * isAlive() when that matters.
+     */
+    std::deque<Archetype>& getArchetypes()
+    {
+        return archetypes;
     }
 
-    const std::map<std::string, EntityVec>& getEntityMap()
+    /**
+     * @brief Per-archetype component memory, to compare against AllComponentsBytesPerEntity
+     */
+    [[nodiscard]] std::vector<ArchetypeMemory> memoryReport() const
     {
-        return entityMap;
+        std::vector<ArchetypeMemory> report;
+        for (const auto& archetype : archetypes)
+        {
+            report.push_back({ archetype.signature(), archetype.size(), archetype.bytesPerEntity() });
+        }
+        return report;
     }
 };
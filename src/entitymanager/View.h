@@ -0,0 +1,120 @@
+//
+// Created by Jorge Jimenez on 6/15/25.
+//
+
+#pragma once
+
+#include "Archetype.h"
+#include <deque>
+#include <type_traits>
+
+/**
+ * @brief Typed query over every entity that has all of the components Ts...
+ *
+ * The required signature is computed at compile time, so matching is one mask test
+ * per archetype and archetypes that don't match are skipped without touching any of
+ * their rows. For matching archetypes each() walks the component columns directly
+ * with the callback inlined into the loop, which replaces the old
+ * "iterate everything, then has<A>() && has<B>()" pattern.
+ *
+ * Views are cheap to create, build them where they are used instead of storing them.
+ * Rows of entities destroyed this frame are still visited until the next
+ * EntityManager::update().
+ *
+ * @example
+ * entityManager.view<CTransform, CShape>()
+ *     .without<CInput>()
+ *     .each([](CTransform& transform, const CShape& shape) {
+ *         transform.pos += transform.velocity;
+ *     });
+ *
+ * // Ask for the handle as the first argument when the entity itself is needed
+ * entityManager.view<const CLifespan>().each([&](EntityHandle e, const CLifespan& lifespan) {
+ *     if (lifespan.remaining(tick) <= 0) entityManager.destroy(e);
+ * });
+ */
+template <typename... Ts>
+class View
+{
+    static_assert(sizeof...(Ts) > 0, "a view needs at least one component type");
+
+    std::deque<Archetype>& archetypes;
+    Signature              excluded = 0;
+
+public:
+    /// Components every matching entity must have
+    static constexpr Signature Required = (componentBit<std::remove_const_t<Ts>>() | ...);
+
+    explicit View(std::deque<Archetype>& archetypes, const Signature excluded = 0)
+        : archetypes(archetypes), excluded(excluded)
+    {}
+
+    /**
+     * @brief Returns a view that also skips entities having any of the components Xs...
+     */
+    template <typename... Xs>
+    [[nodiscard]] View without() const
+    {
+        return View(archetypes, excluded | (componentBit<Xs>() | ...));
+    }
+
+    /// True if entities stored in the archetype are part of this view
+    [[nodiscard]] bool matches(const Archetype& archetype) const
+    {
+        const Signature signature = archetype.signature();
+        return (signature & Required) == Required && (signature & excluded) == 0;
+    }
+
+    /**
+     * @brief Calls f for every matching entity
+     *
+     * f takes either (Ts&... components) or (EntityHandle, Ts&... components).
+     */
+    template <typename F>
+    void each(F&& f) const
+    {
+        for (auto& archetype : archetypes)
+        {
+            if (!matches(archetype)) continue;
+
+            const size_t count = archetype.size();
+            const EntityHandle* entities = archetype.entities().data();
+            auto columns = std::make_tuple(archetype.column<std::remove_const_t<Ts>>().data()...);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                if constexpr (std::is_invocable_v<F&, EntityHandle, Ts&...>)
+                {
+                    f(entities[i], std::get<std::remove_const_t<Ts>*>(columns)[i]...);
+                }
+                else
+                {
+                    f(std::get<std::remove_const_t<Ts>*>(columns)[i]...);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Calls f once per matching archetype, for systems that process whole columns
+     */
+    template <typename F>
+    void eachArchetype(F&& f) const
+    {
+        for (auto& archetype : archetypes)
+        {
+            if (matches(archetype)) f(archetype);
+        }
+    }
+
+    /// Number of matching entities
+    [[nodiscard]] size_t size() const
+    {
+        size_t count = 0;
+        for (const auto& archetype : archetypes)
+        {
+            if (matches(archetype)) count += archetype.size();
+        }
+        return count;
+    }
+};
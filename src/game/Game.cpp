@@ -6,14 +6,18 @@
 #include <cstdlib>
 #include <random>
 #include <numbers>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
-Game::Game(const std::string &config)
+Game::Game(const std::string &config, const std::optional<HeadlessConfig> &headless)
     : m_text(m_font) // Initialize sf::Text with font reference - SFML 3 requires this
 {
-    init(config);
+    init(config, headless);
 }
 
-void Game::init(const std::string &config)
+void Game::init(const std::string &config, const std::optional<HeadlessConfig> &headless)
 {
     srand(time(nullptr));
 
@@ -44,71 +48,115 @@ void Game::init(const std::string &config)
         }
     }
 
-    // set up default window parameters
-    m_window.create(sf::VideoMode(sf::Vector2u(m_windowConfig.W, m_windowConfig.H)), "Assignment 2");
-    m_window.setFramerateLimit(m_windowConfig.FL);
+    if (headless) m_headlessConfig = *headless;
 
-    // Load a font first
-    if (!m_font.openFromFile("assets/" + m_fontConfig.fontFile)) {
-        // Try to load a common system font as fallback
-        if (!m_font.openFromFile("/System/Library/Fonts/Helvetica.ttc")) {
-            std::cerr << "Failed to load fonts!" << std::endl;
+    // a headless run only simulates, so it needs no window, font or gui
+    if (!m_headlessConfig.H)
+    {
+        // set up default window parameters
+        m_window.create(sf::VideoMode(sf::Vector2u(m_windowConfig.W, m_windowConfig.H)), "Assignment 2");
+        m_window.setFramerateLimit(m_windowConfig.FL);
+
+        // Load a font first
+        if (!m_font.openFromFile("assets/" + m_fontConfig.fontFile)) {
+            // Try to load a common system font as fallback
+            if (!m_font.openFromFile("/System/Library/Fonts/Helvetica.ttc")) {
+                std::cerr << "Failed to load fonts!" << std::endl;
+            }
         }
-    }
 
-    // Configure text after font is loaded
-    m_text.setString("Score: 0");
-    m_text.setFont(m_font);
-    m_text.setCharacterSize(m_fontConfig.fontSize);
+        // Configure text after font is loaded
+        m_text.setString("Score: 0");
+        m_text.setFont(m_font);
+        m_text.setCharacterSize(m_fontConfig.fontSize);
 
-    if (!ImGui::SFML::Init(m_window)) {
-        std::cerr << "Failed to initialize ImGui-SFML" << std::endl;
+        if (!ImGui::SFML::Init(m_window)) {
+            std::cerr << "Failed to initialize ImGui-SFML" << std::endl;
+        }
+
+        // scale the imgui ui and text size by 2
+        ImGui::GetStyle().ScaleAllSizes(1.2f);
+        ImGui::GetIO().FontGlobalScale = 1.2f;
     }
 
-    // scale the imgui ui and text size by 2
-    ImGui::GetStyle().ScaleAllSizes(1.2f);
-    ImGui::GetIO().FontGlobalScale = 1.2f;
+    // intern the tags once so systems compare integers instead of strings
+    m_playerTag     = m_entities.internTag("player");
+    m_enemyTag      = m_entities.internTag("enemy");
+    m_smallEnemyTag = m_entities.internTag("Small Enemy");
+    m_spazbitTag    = m_entities.internTag("spazbit");
+    m_bulletTag     = m_entities.internTag("bullet");
+
+    setBroadphase(m_collisionConfig.B);
+
+    // small shapes are drawn with fewer points, see LevelOfDetail
+    m_renderer.setLevelOfDetail({ m_lodConfig.F, static_cast<uint32_t>(std::max(m_lodConfig.P, 3)),
+                                  std::max(m_lodConfig.E, 1.0f), static_cast<size_t>(std::max(m_lodConfig.B, 0)) });
+
+    // pre-warm the entity pools so spawning doesn't allocate mid-game
+    m_entities.reserve(static_cast<size_t>(std::max(m_poolConfig.N, 0)));
+    for (auto& proxies : m_layerProxies) proxies.reserve(static_cast<size_t>(std::max(m_poolConfig.N, 0)));
 
     spawnPlayer();
 }
 
 
-std::shared_ptr<Entity> Game::player()
+EntityHandle Game::player() const
 {
-    auto& players = m_entities.getEntities("player");
-    // assert(players.size() == 1);
-    return players.front();
+    return m_player;
 }
 
 
 void Game::run() {
-    // - add pause functionality in here
-    // - some systems should function while paused (rendering)
-    // - some systems shouldn't (movement / input)
+    if (m_headlessConfig.H)
+    {
+        runHeadless();
+        return;
+    }
+
+    // the simulation advances in fixed ticks, the renderer draws as often as it can and
+    // interpolates between the last two ticks
+    const float tick = 1.0f / static_cast<float>(std::max(m_simulationConfig.TR, 1));
+    // at least one tick per frame, or the simulation would never advance
+    const int maxTicks = std::max(m_simulationConfig.MT, 1);
+
     while (m_running)
     {
-        // update the entity manager
-        m_entities.update();
+        const sf::Time elapsed = m_deltaClock.restart();
 
         // required update call to imgui
-        ImGui::SFML::Update(m_window, m_deltaClock.restart());
+        ImGui::SFML::Update(m_window, elapsed);
 
         if (!m_paused)
         {
+            m_accumulator += elapsed.asSeconds();
+
+            int ticks = 0;
+            while (m_accumulator >= tick && ticks < maxTicks)
+            {
+                simulate();
+                m_accumulator -= tick;
+                ticks++;
+            }
 
-            if (!m_isEnemeySpawnDisabled) sEnemySpawner();
-            if(!m_isMovementDisabled) sMovement();
-            if (!m_isCollisionDisabled) sCollision();
-            if(!m_isLifespanDisabled) sLifespan();
+            // after a slow frame, drop the backlog instead of trying to catch up forever
+            if (m_accumulator >= tick)
+            {
+                m_droppedTicks += static_cast<int>(m_accumulator / tick);
+                m_accumulator = std::fmod(m_accumulator, tick);
+            }
+            m_renderAlpha = m_accumulator / tick;
         }
+        else
+        {
+            m_renderAlpha = 1.0f;
+        }
+
+        // commit entities spawned by input or the gui before drawing them
+        m_entities.update();
 
         sUserInput();
         sGUI();
         sRender();
-
-        // increment the current frame
-        // may need to be moved when pause implemented
-        if (!m_paused) m_currentFrame++;
     }
 
     // cleanup
@@ -117,6 +165,89 @@ void Game::run() {
     m_window.close();
 }
 
+void Game::runHeadless() {
+    using Clock = std::chrono::steady_clock;
+
+    // with no rate the ticks run back to back, otherwise each one waits for its slot
+    const auto tick = m_headlessConfig.R > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_headlessConfig.R))
+        : Clock::duration::zero();
+
+    const auto start = Clock::now();
+    auto nextTick = start;
+    auto lastReport = start;
+    int lastReportTick = 0;
+
+    std::cout << "headless: " << (m_headlessConfig.T > 0 ? std::to_string(m_headlessConfig.T) : "unlimited")
+              << " ticks at " << (m_headlessConfig.R > 0 ? std::to_string(m_headlessConfig.R) + " ticks/s" : "full speed")
+              << std::endl;
+
+    while (m_running && (m_headlessConfig.T <= 0 || m_currentFrame < m_headlessConfig.T))
+    {
+        if (tick != Clock::duration::zero())
+        {
+            std::this_thread::sleep_until(nextTick);
+            nextTick += tick;
+        }
+
+        simulate();
+
+        // report about once a second
+        const auto now = Clock::now();
+        if (now - lastReport >= std::chrono::seconds(1))
+        {
+            const double seconds = std::chrono::duration<double>(now - lastReport).count();
+            std::cout << "tick " << m_currentFrame
+                      << "  " << static_cast<int>((m_currentFrame - lastReportTick) / seconds) << " ticks/s"
+                      << "  " << m_entities.getEntities().size() << " entities" << std::endl;
+            lastReport = now;
+            lastReportTick = m_currentFrame;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "headless: " << m_currentFrame << " ticks in " << seconds << " s, "
+              << static_cast<int>(m_currentFrame / std::max(seconds, 1e-9)) << " ticks/s, "
+              << m_entities.getEntities().size() << " entities, score " << m_score << std::endl;
+}
+
+void Game::simulate() {
+    // update the entity manager
+    m_entities.update();
+
+    sStorePrevious();
+    sSpin();
+    if (!m_isEnemeySpawnDisabled) sEnemySpawner();
+    if(!m_isMovementDisabled) sMovement();
+    if (!m_isCollisionDisabled)
+    {
+        sCollision();
+        sCollisionResponse();
+    }
+    if(!m_isLifespanDisabled) sLifespan();
+    m_tweens.update(m_entities);
+
+    m_currentFrame++;
+    // lifespans stand still while they're turned off, nothing expires on resuming for the time spent paused
+    if (!m_isLifespanDisabled) m_lifespanTick++;
+}
+
+void Game::sStorePrevious() {
+    m_entities.view<CTransform>().each([](CTransform& transform) {
+        transform.prevPos = transform.pos;
+        transform.prevAngle = transform.angle;
+    });
+}
+
+void Game::sSpin() {
+    // every shape spins a degree per tick. The spin is only for looks, so it keeps going
+    // with movement turned off, like it did when it ran at draw time, and stops when paused
+    m_entities.view<CTransform, const CShape>().each([](CTransform& transform, const CShape&) {
+        transform.angle += 1;
+        transform.angle = std::fmod(transform.angle, 360.0f);
+    });
+}
+
 void Game::setPaused(const bool paused) {
     m_paused = paused;
 }
@@ -125,7 +256,7 @@ void Game::setPaused(const bool paused) {
 void Game::spawnPlayer() {
     // Create the base entity with common components
     auto entity = createEntity(
-        "player",                           // tag
+        m_playerTag,                        // tag
         Vec2f(m_windowConfig.W / 2.0f, m_windowConfig.H / 2.0f),  // position
         m_playerConfig.SR,                  // shape radius
         m_playerConfig.V,                   // vertex count
@@ -138,14 +269,15 @@ void Game::spawnPlayer() {
     );
 
     // Add player-specific components
-    entity->add<CInput>();
+    m_entities.add<CInput>(entity);
+    m_entities.get<CCollision>(entity).layer = LAYER_PLAYER;
 
     // Store player entity
     m_player = entity;
 }
 
 // spawn an enemy at a random position
-void Game::spawnEnemy(const std::string& type) {
+void Game::spawnEnemy(const TagId type) {
     // Calculate spawn position, ensuring the enemy is fully within window bounds
     // by accounting for the enemy radius
     const auto enemyRadius = m_enemyConfig.SR;
@@ -188,16 +320,16 @@ void Game::spawnEnemy(const std::string& type) {
         sf::Color(m_enemyConfig.OR, m_enemyConfig.OG, m_enemyConfig.OB),  // outline color
         static_cast<float>(m_enemyConfig.OT),  // outline thickness
         Vec2f(std::cosf(randomAngle) * speed, std::sinf(randomAngle) * speed),  // velocity
-        (type == "spazbit") ? 2000 : m_enemyConfig.L,                                  // lifespan (0 for player)
+        (type == m_spazbitTag) ? 2000 : m_enemyConfig.L,                                  // lifespan (0 for player)
         m_enemyConfig.CR,                   // collision radius
         static_cast<int>(numPoints*100),
         EASEINOUT_EXPO
     );
 
-    if (type == "spazbit")
+    if (type == m_spazbitTag)
     {
-        e->add<CSpazJump>();
-        e->get<CLifespan>().setEasingType(EASEIN_EXPO);
+        m_entities.add<CSpazJump>(e);
+        m_entities.get<CLifespan>(e).setEasingType(EASEIN_EXPO);
     }
 
     // record when the most recent enemy was spawned
@@ -205,50 +337,53 @@ void Game::spawnEnemy(const std::string& type) {
 }
 
 // spawns the small enemies when a big one (input entity e) explodes
-void Game::spawnSmallEnemies(std::shared_ptr<Entity> const& e) {
+void Game::spawnSmallEnemies(const EntityHandle e) {
 
     // when we create the smaller enemy, we have to read the values of the original enemy
     // - spawn a number of small enemies equal to the vertices of the original enemy
     // - set each small enemy to the same color as the original, half the size
     // - small enemies are worth double points of the original enemy
-    const size_t numEnemies = e->get<CShape>().getPointCount();
+    const size_t numEnemies = m_entities.get<CShape>(e).getPointCount();
     const auto interval = 360/static_cast<float>(numEnemies);
-    for (int i = 0; i < numEnemies; i++)
+    for (size_t i = 0; i < numEnemies; i++)
     {
-        auto const smallEnemy = m_entities.addEntity("Small Enemy");
-        auto& transform = e->get<CTransform>();
-        auto& shape = e->get<CShape>();
+        auto const smallEnemy = m_entities.addEntity(m_smallEnemyTag);
+        // copy the parent's values, adding components may move the parent's record
+        const auto transform = m_entities.get<CTransform>(e);
+        const auto& shape = m_entities.get<CShape>(e);
         const auto rads = (static_cast<float>(i) * interval) * static_cast<float>(M_PI /180.0f);
+        const float radius = shape.getRadius()/2;
+        const sf::Color fill = shape.getFillColor();
+        const sf::Color outline = shape.getOutlineColor();
 
-        smallEnemy->add<CTransform>(
+        m_entities.add<CTransform>(smallEnemy,
             transform.pos,
             Vec2f(std::cosf(rads), std::sinf(rads)),
             0.0f);
 
-        smallEnemy->add<CShape>(
-            shape.getRadius()/2, shape.getPointCount(), // radius, points
-            shape.getFillColor(), // fill color
-            shape.getOutlineColor(), // outline color
+        m_entities.add<CShape>(smallEnemy,
+            radius, numEnemies, // radius, points
+            fill, // fill color
+            outline, // outline color
             m_enemyConfig.OT // outline thickness
         );
 
-        smallEnemy->add<CLifespan>(m_enemyConfig.L);
-        smallEnemy->get<CLifespan>().setEasingType(EASEIN_EXPO);
-        smallEnemy->add<CCollision>(m_enemyConfig.CR);
-        smallEnemy->add<CScore>(numEnemies*2*100);
+        addLifespan(smallEnemy, m_enemyConfig.L, EASEIN_EXPO);
+        m_entities.add<CCollision>(smallEnemy, m_enemyConfig.CR);
+        m_entities.add<CScore>(smallEnemy, numEnemies*2*100);
     }
 }
 
 // spawns a bullet from a given entity to a target location
 void Game::spawnBullet(const Vec2f &target) {
-    auto const playerPos(player()->get<CTransform>().pos);
+    auto const playerPos(m_entities.get<CTransform>(player()).pos);
     auto const diff = target - playerPos;
     auto const normalizedVector = Vec2f::normalize(diff);
     auto const velocity = normalizedVector * m_bulletConfig.S;
 
     // Create bullet entity with factory
     auto bullet = createEntity(
-        "bullet",                           // tag
+        m_bulletTag,                        // tag
         playerPos,                          // position
         m_bulletConfig.SR,                  // shape radius
         m_bulletConfig.V,                   // vertex count
@@ -261,204 +396,167 @@ void Game::spawnBullet(const Vec2f &target) {
         0,                                  // score (bullets don't have score)
         EASEOUT_SINE                        // easing function
     );
+
+    // bullets are fast enough to skip over small enemies, so they're swept
+    if (m_entities.has<CCollision>(bullet))
+    {
+        auto& collision = m_entities.get<CCollision>(bullet);
+        collision.layer = LAYER_BULLET;
+        collision.swept = true;
+    }
 }
 
-void Game::spawnSpecialWeapon(std::shared_ptr<Entity> entity) {
+void Game::spawnSpecialWeapon(EntityHandle entity) {
     // TODO: implement your own special weapon
 }
 
-void Game::spazbitMovement(std::shared_ptr<Entity> entity)
-{
-    auto& spaz      = entity->get<CSpazJump>();
-    auto& transform = entity->get<CTransform>();
-    const float r   = entity->get<CShape>().getRadius();
-    const auto W   = static_cast<float>(m_windowConfig.W);
-    const auto H   = static_cast<float>(m_windowConfig.H);
-
-    // 1) Reset jump if completed (use >= to avoid float-eq)
-    if (spaz.distanceTraveled >= spaz.distanceToTravel)
-    {
-        // 2) Better RNG
-        static thread_local std::mt19937 gen{ std::random_device{}() };
-        std::uniform_real_distribution angDist(0.0f, 2.0f * std::numbers::pi_v<float>);
-        std::uniform_real_distribution speedDist(m_enemyConfig.SMIN, m_enemyConfig.SMAX);
-
-        // random distance to travel
-        std::uniform_real_distribution distDist(50.0f, 200.0f);
+void Game::sMovement() {
+    const auto windowWidth = static_cast<float>(m_windowConfig.W);
+    const auto windowHeight = static_cast<float>(m_windowConfig.H);
+
+    // spazbits move in jumps, one batch per archetype
+    const SpazbitSystem::Params spazbitParams{ Vec2f(windowWidth, windowHeight), m_enemyConfig.SMIN, m_enemyConfig.SMAX };
+    m_entities.view<CTransform, CSpazJump, const CShape, const CLifespan>()
+        .eachArchetype([&](Archetype& archetype) {
+            m_spazbits.update(archetype.column<CTransform>(), archetype.column<CSpazJump>(),
+                              archetype.column<CShape>(), archetype.column<CLifespan>(), spazbitParams);
+        });
+
+    // everything else bounces off the window edges, the player moves from input below.
+    // The integrator moves each archetype's transform column with one branch-free kernel,
+    // without one the plain loop is faster than packing the radii
+    const Vec2f bounds(windowWidth, windowHeight);
+    m_entities.view<CTransform, const CShape>()
+        .without<CInput, CSpazJump>()
+        .eachArchetype([&](Archetype& archetype) {
+            const auto transforms = archetype.column<CTransform>();
+            const auto shapes = archetype.column<CShape>();
+            if (m_integrator.level() == SimdLevel::Scalar)
+            {
+                for (size_t i = 0; i < shapes.size(); i++) Integrator::bounce(transforms[i], shapes[i].radius, bounds);
+                return;
+            }
 
-        const float angle = angDist(gen);
-        const float speed = speedDist(gen);
+            m_radii.resize(shapes.size());
+            for (size_t i = 0; i < shapes.size(); i++) m_radii[i] = shapes[i].radius;
+            m_integrator.run(transforms, m_radii, bounds);
+        });
 
-        transform.velocity = Vec2f{ std::cosf(angle) * speed,
-                                    std::sinf(angle) * speed };
+    if (m_entities.isAlive(player()) && m_entities.has<CTransform>(player())) {
+        auto& transform = m_entities.get<CTransform>(player());
+        const auto& input = m_entities.get<CInput>(player());
 
-        spaz.distanceToTravel = distDist(gen);
-        spaz.distanceTraveled = 0.0f;
+        if (input.up) transform.pos.y -= transform.velocity.y;     // Up decreases Y
+        if (input.down) transform.pos.y += transform.velocity.y;   // Down increases Y
+        if (input.left) transform.pos.x -= transform.velocity.x;   // Left decreases X
+        if (input.right) transform.pos.x += transform.velocity.x;  // Right increases X
     }
+}
 
-    // 3) Safe progress compute
-    float progress = (spaz.distanceToTravel > 0.0f)
-        ? std::clamp(spaz.distanceTraveled / spaz.distanceToTravel, 0.0f, 1.0f)
-        : 1.0f;
-
-    const float offsetFactor = m_interpolations.interpolate(progress, entity->get<CLifespan>().getEasing());
-    const Vec2f movement = transform.velocity * offsetFactor;
-
-    // 4) Move & bounce
-    transform.pos += movement;
-
-    // Bounce on X
-    if (transform.pos.x - r < 0.0f || transform.pos.x + r > W)
-    {
-        transform.velocity.x = -transform.velocity.x;
-        // clamp so we don’t get stuck outside
-        transform.pos.x = std::clamp(transform.pos.x, r, W - r);
-    }
+void Game::sLifespan() {
+    // destroy the entities whose lifespan runs out this tick, spazbits don't expire
+    m_expiries.advance(m_lifespanTick, [this](const EntityHandle e) {
+        const CLifespan* lifespan = m_entities.find<CLifespan>(e);
+        if (lifespan && lifespan->expiresAt <= m_lifespanTick && !m_entities.has<CSpazJump>(e)) m_entities.destroy(e);
+    });
+}
 
-    // Bounce on Y
-    if (transform.pos.y - r < 0.0f || transform.pos.y + r > H)
-    {
-        transform.velocity.y = -transform.velocity.y;
-        transform.pos.y = std::clamp(transform.pos.y, r, H - r);
+void Game::sCollision() {
+    // detection only reads the world, everything it finds goes out as events
+    for (auto& proxies : m_layerProxies) proxies.clear();
+    m_entities.view<const CTransform, const CCollision>().each(
+        [&](const EntityHandle entity, const CTransform& transform, const CCollision& collision) {
+            // swept entities are tested along this frame's movement, so fast ones can't skip past a target
+            const bool swept = collision.swept && !m_isMovementDisabled;
+            m_layerProxies[collision.layer].push_back(
+                { entity, transform.pos, collision.radius, swept ? transform.velocity : Vec2f(0, 0) });
+        });
+
+    // each target layer goes into the broadphase once, then every layer that collides
+    // with it queries it, lower layers query higher ones
+    for (int target = 0; target < LAYER_COUNT; target++) {
+        const auto targetLayer = static_cast<CollisionLayer>(target);
+        const uint32_t queryLayers = m_collisionConfig.M.mask(targetLayer) & ((2u << target) - 1);
+        if (queryLayers == 0 || m_layerProxies[target].empty()) continue;
+
+        m_broadphase->update(m_layerProxies[target]);
+        for (int query = 0; query <= target; query++) {
+            if (queryLayers & (1u << query)) collideLayers(static_cast<CollisionLayer>(query), targetLayer);
+        }
     }
 
-    spaz.distanceTraveled += 1.0f;
-
+    m_collisionEvents.publish();
 }
 
-void Game::sMovement() {
-    for (const auto& e: m_entities.getEntities())
-    {
-        // if entity has transform component...
-        if (e->tag() == "player") continue;
+void Game::collideLayers(const CollisionLayer queryLayer, const CollisionLayer targetLayer) {
+    const auto& queries = m_layerProxies[queryLayer];
+    if (queries.empty()) return;
 
-        if (e->tag() == "spazbit")
-        {
-           spazbitMovement(e);
-            continue;
-        }
+    // only the candidates the broadphase finds need the exact test
+    m_broadphase->findPairs(queries, m_collisionPairs);
 
+    m_narrowphase.clear();
+    for (const auto& [query, target] : m_collisionPairs) {
+        m_narrowphase.add(queries[query].pos, queries[query].radius, target.pos, target.radius, queries[query].motion);
+    }
 
-        if (e->has<CTransform>() && e->has<CShape>())
-        {
-            auto& transform = e->get<CTransform>();
-            const auto& shape = e->get<CShape>();
+    // hits come grouped by query, swept queries only report the first thing on their path
+    const auto hits = m_narrowphase.run();
+    for (size_t begin = 0, end = 0; begin < hits.size(); begin = end) {
+        const uint32_t query = m_collisionPairs[hits[begin]].query;
+        while (end < hits.size() && m_collisionPairs[hits[end]].query == query) end++;
 
-            const float posX = transform.pos.x;
-            const float posY = transform.pos.y;
-            const float radius = shape.circle.getRadius();
-            const auto windowWidth = static_cast<float>(m_windowConfig.W);
-            const auto windowHeight = static_cast<float>(m_windowConfig.H);
+        const EntityHandle entity = queries[query].entity;
+        int64_t first = -1;
+        float firstTime = 2.0f;
+        for (size_t h = begin; h < end; h++) {
+            const EntityHandle other = m_collisionPairs[hits[h]].target.entity;
 
-            if ((posX - radius) < 0 || (posX + radius) > windowWidth)
-                    transform.velocity.x *= -1;
-            if ((posY - radius) < 0 || (posY + radius) > windowHeight)
-                    transform.velocity.y *= -1;
+            // within one layer every pair is seen from both sides, keep one
+            if (queryLayer == targetLayer && other.index <= entity.index) continue;
 
-            transform.pos.y += transform.velocity.y;
-            transform.pos.x += transform.velocity.x;
+            const auto time = m_narrowphase.timeOfImpact(hits[h]);
+            if (queries[query].motion == Vec2f(0, 0)) {
+                m_collisionEvents.emit({ entity, other, queryLayer, targetLayer, time });
+            }
+            else if (time < firstTime) {
+                first = hits[h];
+                firstTime = time;
+            }
         }
-    }
-
-    if (player() && player()->has<CTransform>()) {
-        auto& transform = player()->get<CTransform>();
-        const auto& input = player()->get<CInput>();
 
-        if (input.up) transform.pos.y -= transform.velocity.y;     // Up decreases Y
-        if (input.down) transform.pos.y += transform.velocity.y;   // Down increases Y
-        if (input.left) transform.pos.x -= transform.velocity.x;   // Left decreases X
-        if (input.right) transform.pos.x += transform.velocity.x;  // Right increases X
+        if (first >= 0) {
+            m_collisionEvents.emit({ entity, m_collisionPairs[first].target.entity, queryLayer, targetLayer, firstTime });
+        }
     }
 }
 
-void Game::sLifespan() {
-    // for all entities
-    for (const auto& e: m_entities.getEntities())
-    {
-        if (e->tag() == "spazbit") continue;
-
-        // - if entity has no lifespan component, skip it
-        if (!e->has<CLifespan>() || !e->isActive()) continue;
+void Game::sCollisionResponse() {
+    for (const auto& event : m_collisionEvents.published()) {
+        // an earlier event this frame may already have destroyed one of them
+        if (!m_entities.isAlive(event.a) || !m_entities.isAlive(event.b)) continue;
 
-        // - if entity has > 0 remaining lifespan, subtract 1
-        auto& lifespan = e->get<CLifespan>();
-        lifespan.remaining--;
-
-        if (lifespan.remaining <= 0)
-        {
-            // - if it has lifespan and its time is up destroy the entity
-            e->destroy();
-            continue;
+        if (event.layerA == LAYER_BULLET && event.layerB == LAYER_ENEMY) {
+            if (m_entities.tagId(event.b) == m_enemyTag) spawnSmallEnemies(event.b);
+            if (m_entities.has<CScore>(event.b)) m_score += m_entities.get<CScore>(event.b).score;
+            m_entities.destroy(event.a);
+            m_entities.destroy(event.b);
+        }
+        else if (event.layerA == LAYER_PLAYER && event.layerB == LAYER_ENEMY) {
+            // the enemy breaks apart and the player starts over from the middle
+            if (m_entities.tagId(event.b) == m_enemyTag) spawnSmallEnemies(event.b);
+            m_entities.destroy(event.b);
+            m_entities.get<CTransform>(event.a).teleport(Vec2f(m_windowConfig.W / 2.0f, m_windowConfig.H / 2.0f));
         }
-            // - if it has lifespan and is alive scale its alpha channel properly
-            auto& shape = e->get<CShape>();
-            sf::Color currColor = shape.getFillColor();
-            
-            // Calculate the normalized progress (0.0 to 1.0)
-            float progress = static_cast<float>(lifespan.remaining) / static_cast<float>(lifespan.lifespan);
-            
-            // Clamp progress between 0.1 and 1.0 as requested
-            progress = std::max(0.0f, std::min(progress, 1.0f));
-            
-            // Apply the smooth interpolation to calculate alpha
-            const float newAlpha =
-                m_interpolations.interpolate(progress, lifespan.getEasing()) * 255.0f;
-
-            shape.setFillColor(sf::Color(currColor.r, currColor.g, currColor.b, static_cast<uint8_t>(newAlpha)));
-            shape.setOutlineColor(sf::Color(255, 255, 255, static_cast<uint8_t>(newAlpha)));
     }
 }
 
-void Game::sCollision() {
-    // TODO: implement all proper collisions between entities
-    // be sure to use the collision radius, not the shape radius
-    // sample
-    for (auto const& bullet: m_entities.getEntities("bullet")) {
-        if (!bullet->isActive()) continue;
-        const auto& bulletTransform = bullet->get<CTransform>();
-
-        for (auto const& entity: m_entities.getEntities())
-        {
-            if (entity->tag() == "bullet" || entity->tag() == "player") continue;
-            if (!entity->isActive()) continue;
-
-            //check collision
-            const auto& entityTransform = entity->get<CTransform>();
-            const auto diff = bulletTransform.pos - entityTransform.pos;
-            const auto dist = diff.x*diff.x + diff.y*diff.y;
-            const auto r1 = bullet->get<CCollision>().radius;
-            const auto r2 = entity->get<CCollision>().radius;
-
-            if (dist < ((r1+r2) * (r1+r2)))
-            {
-                if (entity->tag() == "enemy") spawnSmallEnemies(entity);
-                m_score += entity->get<CScore>().score;
-                bullet->destroy();
-                entity->destroy();
-
-            }
-        }
-        //
-        // for (auto const& entity: m_entities.getEntities())
-        // {
-        //     if (entity->tag() == "butllet" || entity->tag() == "player") continue;
-        //     if (!entity->isActive()) continue;
-        //     //check collision
-        //     const auto entityTransform = entity->get<CTransform>();
-        //     const auto diff = bulletTransform.pos - entityTransform.pos;
-        //     const auto dist = diff.x*diff.x + diff.y*diff.y;
-        //     const auto r1 = bullet->get<CCollision>().radius;
-        //     const auto r2 = entity->get<CCollision>().radius;
-        //
-        //     if (dist < ((r1+r2) * (r1+r2)) && entity->tag() == "enemy")
-        //     {
-        //         // spawnSmallEnemies(entity);
-        //         bullet->destroy();
-        //         entity->destroy();
-        //     }
-        // }
-        // we need another loop for small entities because small entities don't spawn further
-    }
+void Game::setBroadphase(const BroadphaseType type)
+{
+    // a cell about as wide as an enemy keeps each bullet's query to a few cells
+    const float cellSize = 2.0f * static_cast<float>(std::max(m_enemyConfig.CR, m_bulletConfig.CR));
+    m_broadphase = makeBroadphase(type, cellSize);
+    m_collisionConfig.B = type;
 }
 
 void Game::sEnemySpawner() {
@@ -466,9 +564,9 @@ void Game::sEnemySpawner() {
     if (elapsedTime > m_enemyConfig.SI)
     {
         if (elapsedTime % 7 == 0)
-            spawnEnemy("spazbit");
+            spawnEnemy(m_spazbitTag);
         else
-            spawnEnemy("enemy");
+            spawnEnemy(m_enemyTag);
     }
 }
 
@@ -479,6 +577,7 @@ void Game::sGUI() {
     guiLogging();
     guiSpawner();
     guiEntityTable();
+    guiMemory();
 
     ImGui::End();
 }
@@ -486,27 +585,13 @@ void Game::sGUI() {
 void Game::sRender() {
     m_window.clear();
 
-    // Get all entities
-    auto entities = m_entities.getEntities();
-    // Iterate through all entities
-    for (const auto& entity : entities) {
-        // Only draw entities that have both transform and shape components
-        if (entity->has<CTransform>() && entity->has<CShape>()) {
-            auto& transform = entity->get<CTransform>();
-            auto& shape = entity->get<CShape>();
-
-            // update rotation
-            transform.angle += 1;
-            transform.angle = std::fmod(transform.angle, 360.0f);
-
-            // Update position and rotation
-            shape.circle.setPosition(transform.pos);
-            shape.circle.setRotation(sf::degrees(transform.angle));
-
-            // Draw the entity
-            m_window.draw(shape.circle);
-        }
-    }
+    // every entity with a transform and a shape in view, drawn between the last two ticks in one draw call
+    // timed shapes fade as they are drawn, standing still while lifespans are off
+    m_renderer.setLifespanTime(static_cast<float>(m_lifespanTick - 1) + (m_isLifespanDisabled ? 1.0f : m_renderAlpha));
+    const sf::View& view = m_window.getView();
+    const float pixelsPerUnit = static_cast<float>(m_window.getSize().x) * view.getViewport().size.x / view.getSize().x;
+    m_renderer.build(m_entities, m_renderAlpha, view, pixelsPerUnit);
+    m_renderer.draw(m_window);
 
     // draw the ui last
     std::stringstream ss;
@@ -543,26 +628,26 @@ void Game::sUserInput() {
         else if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>()) {
             switch (keyEvent->scancode) {
                 case sf::Keyboard::Scancode::W:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().up = true;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).up = true;
                     }
                     break;
                 case sf::Keyboard::Scancode::P:
                     m_paused = !m_paused;
                     break;
                 case sf::Keyboard::Scancode::S:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().down = true;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).down = true;
                     }
                     break;
                 case sf::Keyboard::Scancode::A:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().left = true;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).left = true;
                     }
                     break;
                 case sf::Keyboard::Scancode::D:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().right = true;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).right = true;
                     }
                     break;
                 case sf::Keyboard::Scancode::Escape:
@@ -576,23 +661,23 @@ void Game::sUserInput() {
         else if (const auto* keyEvent = event.getIf<sf::Event::KeyReleased>()) {
             switch (keyEvent->scancode) {
                 case sf::Keyboard::Scancode::W:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().up = false;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).up = false;
                     }
                     break;
                 case sf::Keyboard::Scancode::S:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().down = false;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).down = false;
                     }
                     break;
                 case sf::Keyboard::Scancode::A:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().left = false;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).left = false;
                     }
                     break;
                 case sf::Keyboard::Scancode::D:
-                    if (player() && player()->has<CInput>()) {
-                        player()->get<CInput>().right = false;
+                    if (m_entities.isAlive(player()) && m_entities.has<CInput>(player())) {
+                        m_entities.get<CInput>(player()).right = false;
                     }
                     break;
                 default:
@@ -629,6 +714,12 @@ void Game::parseConfig(const std::string & type, const std::string & values)
     // Player 32 32 5 5 5 5 255 0 0 4 8 500
     // Enemy 32 32 3 3 255 255 255 2 3 8 90 60
     // Bullet 10 10 20 255 255 255 255 255 255 2 20 3
+    // Pool 1024
+    // Collision grid
+    // Collide bullet enemy
+    // Simulation 60 5
+    // Headless 0 0 0
+    // Lod 12 4 10 300000
     // // W = width, H = height, FL = frame limit, FS = full screen ( 1 = true, 0 = false)
 
     std::stringstream ss(values);
@@ -768,6 +859,77 @@ void Game::parseConfig(const std::string & type, const std::string & values)
             m_fontConfig.B = std::stoi(value);
             return;
         }
+
+        if (type == "Pool")
+        {
+            // struct PoolConfig{int N;};
+            ss >> value;
+            m_poolConfig.N = std::stoi(value);
+            return;
+        }
+
+        if (type == "Headless")
+        {
+            // struct HeadlessConfig{bool H; int T, R;};
+            ss >> value;
+            m_headlessConfig.H = std::stoi(value) != 0;
+            ss >> value;
+            m_headlessConfig.T = std::stoi(value);
+            ss >> value;
+            m_headlessConfig.R = std::stoi(value);
+            return;
+        }
+
+        if (type == "Simulation")
+        {
+            // struct SimulationConfig{int TR, MT;};
+            ss >> value;
+            m_simulationConfig.TR = std::stoi(value);
+            ss >> value;
+            m_simulationConfig.MT = std::stoi(value);
+            return;
+        }
+
+        if (type == "Lod")
+        {
+            // struct LodConfig{float F; int P; float E; int B;};
+            ss >> value;
+            m_lodConfig.F = std::stof(value);
+            ss >> value;
+            m_lodConfig.P = std::stoi(value);
+            ss >> value;
+            m_lodConfig.E = std::stof(value);
+            ss >> value;
+            m_lodConfig.B = std::stoi(value);
+            return;
+        }
+
+        if (type == "Collide")
+        {
+            // the first Collide line replaces the default matrix
+            if (!m_collisionConfig.customM)
+            {
+                m_collisionConfig.M = CollisionMatrix();
+                m_collisionConfig.customM = true;
+            }
+
+            std::string other;
+            ss >> value >> other;
+            const auto a = collisionLayerFromName(value);
+            const auto b = collisionLayerFromName(other);
+            if (a && b) m_collisionConfig.M.enable(*a, *b);
+            else ssDebug << "Unknown collision layers '" << value << "' '" << other << "'\n";
+            return;
+        }
+
+        if (type == "Collision")
+        {
+            // struct CollisionConfig{BroadphaseType B;};
+            ss >> value;
+            if (const auto broadphase = broadphaseFromName(value)) m_collisionConfig.B = *broadphase;
+            else ssDebug << "Unknown broadphase '" << value << "', using " << BroadphaseNames[static_cast<int>(m_collisionConfig.B)] << "\n";
+            return;
+        }
     }
     catch (std::exception& e)
     {
@@ -780,8 +942,8 @@ void Game::guiSpawner()
 {
     if (ImGui::CollapsingHeader("Entity Spawner"))
     {
-        if (ImGui::Button("Spawn Enemy")) spawnEnemy("enemy");
-        if (ImGui::Button("Spawn spazbit")) spawnEnemy("spazbit");
+        if (ImGui::Button("Spawn Enemy")) spawnEnemy(m_enemyTag);
+        if (ImGui::Button("Spawn spazbit")) spawnEnemy(m_spazbitTag);
 
     }
 }
@@ -795,6 +957,45 @@ void Game::guiLogging() const
         ImGui::TextColored(ImVec4(0.0f, 1.0f, 1.0f, 1.0f), ssDebug.str().c_str());
 }
 
+void Game::guiMemory()
+{
+    if (ImGui::CollapsingHeader("Memory"))
+    {
+        size_t totalEntities = 0;
+        size_t totalBytes = 0;
+
+        for (const auto& [signature, entities, bytesPerEntity] : m_entities.memoryReport())
+        {
+            // list the components that make up the archetype
+            std::string components;
+            for (size_t i = 0; i < std::size(ComponentNames); i++)
+            {
+                if (signature & (Signature{1} << i))
+                {
+                    if (!components.empty()) components += " ";
+                    components += ComponentNames[i];
+                }
+            }
+
+            ImGui::Text("%5zu x %4zu B  %s", entities, bytesPerEntity, components.c_str());
+            totalEntities += entities;
+            totalBytes += entities * bytesPerEntity;
+        }
+
+        const size_t average = totalEntities > 0 ? totalBytes / totalEntities : 0;
+        ImGui::Separator();
+        ImGui::Text("Average: %zu B per entity (%zu B for one holding every current component)",
+                    average, EntityManager::AllComponentsBytesPerEntity);
+        ImGui::Text("Total: %zu B for %zu entities", totalBytes, totalEntities);
+
+        const auto pool = m_entities.poolStats();
+        ImGui::SeparatorText("Pools");
+        ImGui::Text("Heap allocations: %zu", pool.heapAllocations);
+        ImGui::Text("Recycled: %zu slots, %zu staging records", pool.slotsRecycled, pool.recordsRecycled);
+        ImGui::Text("Pooled rows: %zu", pool.pooledRows);
+    }
+}
+
 void Game::guiOptions()
 {
     // add dials for player velocity and size
@@ -809,7 +1010,7 @@ void Game::guiOptions()
             ImGui::SliderFloat("Player Size", &yVel,
                     1.0f, 10.0f);
 
-            player()->get<CTransform>().velocity = Vec2f(xVel, yVel);
+            m_entities.get<CTransform>(player()).velocity = Vec2f(xVel, yVel);
         }
         ImGui::EndGroup();
 
@@ -819,26 +1020,41 @@ void Game::guiOptions()
         ImGui::Checkbox("Collisions", &m_isCollisionDisabled);
         ImGui::Checkbox("Lifespan", &m_isLifespanDisabled);
 
-        // Array of string labels matching your enum values in the same order
-        const char* interpolationTypeLabels[] = {
-            "Ease Out Elastic",
-            "Ease Out Sine",
-            "Ease In Elastic",
-            "Ease In Sine",
-            "Ease In Out Sine",
-            "Ease In Out Elastic",
-            "Ease In Out Expo",
-            "Ease In Expo",
-        };
-
         // Create the combo box with your enum
         int currentItem = static_cast<int>(m_debugEasing); // Use your enum variable
-        if (ImGui::Combo("Interpolation Type", &currentItem, interpolationTypeLabels, IM_ARRAYSIZE(interpolationTypeLabels)))
+        if (ImGui::Combo("Interpolation Type", &currentItem, InterpolationTypeNames, IM_ARRAYSIZE(InterpolationTypeNames)))
         {
             // Update your enum variable when selection changes
             m_debugEasing = static_cast<InterpolationType>(currentItem);
         }
 
+        int broadphase = static_cast<int>(m_broadphase->type());
+        if (ImGui::Combo("Broadphase", &broadphase, BroadphaseNames, IM_ARRAYSIZE(BroadphaseNames)))
+        {
+            setBroadphase(static_cast<BroadphaseType>(broadphase));
+        }
+        ImGui::Text("Narrowphase: %s", SimdLevelNames[static_cast<int>(m_narrowphase.level())]);
+        ImGui::Text("Simulation: %d ticks/s, %d ticks dropped", m_simulationConfig.TR, m_droppedTicks);
+        const auto& render = m_renderer.stats();
+        ImGui::Text("Render: %zu shapes drawn, %zu culled, %zu vertices, %zu draw calls",
+                    render.shapes, render.culled, render.vertices, render.drawCalls);
+        ImGui::Text("Render build: %.2f ms on %zu threads", render.buildMs, render.threads);
+        ImGui::Text("Render LOD: %zu shapes reduced, edges stretched %.2fx", render.reduced, render.edgeScale);
+
+        ImGui::SeparatorText("Collision Matrix");
+        for (int a = 0; a < LAYER_COUNT; a++)
+        {
+            for (int b = a; b < LAYER_COUNT; b++)
+            {
+                const auto layerA = static_cast<CollisionLayer>(a);
+                const auto layerB = static_cast<CollisionLayer>(b);
+                const std::string label = std::string(CollisionLayerNames[a]) + " / " + CollisionLayerNames[b];
+
+                bool enabled = m_collisionConfig.M.collides(layerA, layerB);
+                if (ImGui::Checkbox(label.c_str(), &enabled)) m_collisionConfig.M.enable(layerA, layerB, enabled);
+            }
+        }
+
         ImGui::EndGroup();
     }
   }
@@ -863,24 +1079,24 @@ void Game::guiEntityTable()
             ImGui::TableSetupColumn("Children", ImGuiTableColumnFlags_WidthFixed, 70.0f);
             ImGui::TableHeadersRow();
 
-            for (const auto& entity : m_entities.getEntities())
+            for (const auto entity : m_entities.getEntities())
             {
-                if (!entity->isActive()) continue;
+                if (!m_entities.isAlive(entity)) continue;
                 
                 ImGui::TableNextRow();
                 
                 // Column 0: Entity ID
                 ImGui::TableSetColumnIndex(0);
-                ImGui::Text("%zu", entity->id());
+                ImGui::Text("%zu", m_entities.id(entity));
                 
                 // Column 1: Entity Type (tag)
                 ImGui::TableSetColumnIndex(1);
-                ImGui::Text("%s", entity->tag().c_str());
+                ImGui::Text("%s", m_entities.tag(entity).c_str());
                 
                 // Only display position if entity has a transform component
-                if (entity->has<CTransform>())
+                if (m_entities.has<CTransform>(entity))
                 {
-                    const auto& transform = entity->get<CTransform>();
+                    const auto& transform = m_entities.get<CTransform>(entity);
                     
                     // Column 2: X Position
                     ImGui::TableSetColumnIndex(2);
@@ -902,10 +1118,10 @@ void Game::guiEntityTable()
                 
                 // Column 4: Lifespan remaining
                 ImGui::TableSetColumnIndex(4);
-                if (entity->has<CLifespan>())
+                if (m_entities.has<CLifespan>(entity))
                 {
-                    const auto& lifespan = entity->get<CLifespan>();
-                    ImGui::Text("%d/%d", lifespan.remaining, lifespan.lifespan);
+                    const auto& lifespan = m_entities.get<CLifespan>(entity);
+                    ImGui::Text("%d/%d", lifespan.remaining(m_lifespanTick), lifespan.lifespan);
                 }
                 else
                 {
@@ -914,9 +1130,9 @@ void Game::guiEntityTable()
 
                 // Column 5: Number of points
                 ImGui::TableSetColumnIndex(5);
-                if (entity->has<CShape>())
+                if (m_entities.has<CShape>(entity))
                 {
-                    const auto& shape = entity->get<CShape>();
+                    const auto& shape = m_entities.get<CShape>(entity);
                     ImGui::Text("%d", shape.getPointCount());
                 } else
                 {
@@ -927,20 +1143,20 @@ void Game::guiEntityTable()
                 ImGui::TableSetColumnIndex(6);
                 
                 // Create a unique label for the button using entity ID
-                std::string buttonLabel = "Remove##" + std::to_string(entity->id());
+                std::string buttonLabel = "Remove##" + std::to_string(m_entities.id(entity));
                 
                 // Add the Remove button
                 if (ImGui::Button(buttonLabel.c_str()))
                 {
                     // Mark the entity for deletion when button is clicked
-                    entity->destroy();
+                    m_entities.destroy(entity);
                 }
 
                 // Column 6: Remove button
                 ImGui::TableSetColumnIndex(7);
 
                 // Create a unique label for the button using entity ID
-                std::string btnChildren = "children##" + std::to_string(entity->id());
+                std::string btnChildren = "children##" + std::to_string(m_entities.id(entity));
 
                 // Add the Remove button
                 if (ImGui::Button(btnChildren.c_str()))
@@ -955,8 +1171,16 @@ void Game::guiEntityTable()
     }
 }
 
+// gives the entity a lifespan counted from the current lifespan tick and schedules its expiry,
+// lifespans are only ever added through here so none goes unscheduled
+void Game::addLifespan(const EntityHandle entity, const int lifespan, const InterpolationType easing) {
+    CLifespan& added = m_entities.add<CLifespan>(entity, lifespan, m_lifespanTick);
+    added.setEasingType(easing);
+    m_expiries.schedule(entity, static_cast<uint32_t>(added.expiresAt));
+}
+
 // Add to Game.cpp
-std::shared_ptr<Entity> Game::createEntity(const std::string& tag,
+EntityHandle Game::createEntity(const TagId tag,
                                          const Vec2f& position,
                                          int shapeRadius,
                                          size_t vertexCount,
@@ -972,23 +1196,22 @@ std::shared_ptr<Entity> Game::createEntity(const std::string& tag,
     auto entity = m_entities.addEntity(tag);
 
     // Add transform component
-    entity->add<CTransform>(position, velocity, 0.0f);
+    m_entities.add<CTransform>(entity, position, velocity, 0.0f);
 
     // Add shape component
-    entity->add<CShape>(shapeRadius, vertexCount, fillColor, outlineColor, outlineThickness);
+    m_entities.add<CShape>(entity, shapeRadius, vertexCount, fillColor, outlineColor, outlineThickness);
 
     // Add optional components based on provided parameters
     if (lifespan > 0) {
-        entity->add<CLifespan>(lifespan);
-        entity->get<CLifespan>().setEasingType(easing);
+        addLifespan(entity, lifespan, easing);
     }
 
     if (collisionRadius > 0) {
-        entity->add<CCollision>(collisionRadius);
+        m_entities.add<CCollision>(entity, collisionRadius);
     }
 
     if (score > 0) {
-        entity->add<CScore>(score);
+        m_entities.add<CScore>(entity, score);
     }
 
     return entity;
@@ -4,7 +4,17 @@
 #include <SFML/Graphics.hpp>
 #include "../entitymanager/EntityManager.h"
 #include "../systems/Systems.h"
+#include "../systems/SpazbitSystem.h"
+#include "../systems/TweenSystem.h"
+#include "../systems/TimingWheel.h"
+#include "../collision/Broadphase.h"
+#include "../collision/Narrowphase.h"
+#include "../collision/CollisionLayers.h"
+#include "../collision/CollisionEvents.h"
+#include "../physics/Integrator.h"
+#include "../render/BatchRenderer.h"
 #include "Vec2.h"
+#include <optional>
 #include <sstream>
 
 
@@ -14,6 +24,17 @@ struct BulletConfig{int SR, CR, FR, FG, FB, OR, OG, OB, OT, V, L; float S; };
 // W = width, H = height, FL = frame limit, FS = full screen ( 1 = true, 0 = false)
 struct WindowConfig{int W, H, FL, FS;};
 struct FontConfig{std::string fontFile; int fontSize; int R, G, B;};
+// N = entities the pools are pre-warmed for
+struct PoolConfig{int N = 0;};
+// TR = simulation ticks per second, MT = most ticks run per rendered frame before dropping time
+struct SimulationConfig{int TR = 60; int MT = 5;};
+// H = run without a window, T = ticks to run (0 = until killed), R = ticks per second (0 = as fast as possible)
+struct HeadlessConfig{bool H = false; int T = 0; int R = 0;};
+// F = on-screen radius in pixels from which shapes keep their exact point count (0 = no LOD), P = fewest points
+// a smaller shape is cut to, E = on-screen edge length in pixels they aim for, B = vertices per frame (0 = no budget)
+struct LodConfig{float F = 0; int P = 3; float E = 6; int B = 0;};
+// B = broadphase backend (grid, tree or brute), M = which layers collide, from "Collide" lines
+struct CollisionConfig{BroadphaseType B = BroadphaseType::Grid; CollisionMatrix M = CollisionMatrix::defaults(); bool customM = false;};
 
 
 class Game
@@ -28,11 +49,19 @@ class Game
     BulletConfig        m_bulletConfig;
     WindowConfig        m_windowConfig;
     FontConfig          m_fontConfig;
+    PoolConfig          m_poolConfig;
+    SimulationConfig    m_simulationConfig;
+    HeadlessConfig      m_headlessConfig;
+    CollisionConfig     m_collisionConfig;
+    LodConfig           m_lodConfig;
 
-    Interpolate      m_interpolations;
     sf::Clock        m_deltaClock;
     int              m_score                 = 0;
-    int              m_currentFrame          = 0;
+    int              m_currentFrame          = 0;  // simulation ticks so far
+    int              m_lifespanTick          = 0;  // ticks simulated with lifespans on, the clock lifespans count on
+    float            m_accumulator           = 0;  // real time not yet simulated, in seconds
+    float            m_renderAlpha           = 1;  // how far between the last two ticks to draw
+    int              m_droppedTicks          = 0;  // ticks skipped by the catch-up cap
     int              m_lastEnemySpawnTime    = 0;
     bool             m_paused                = false;
     bool             m_running               = true;
@@ -40,11 +69,28 @@ class Game
     bool             m_isMovementDisabled    = false;
     bool             m_isCollisionDisabled   = false;
     bool             m_isLifespanDisabled    = false;
-    std::shared_ptr<Entity> m_player;
+    EntityHandle     m_player;
+    TagId            m_playerTag             = 0;
+    TagId            m_enemyTag              = 0;
+    TagId            m_smallEnemyTag         = 0;
+    TagId            m_spazbitTag            = 0;
+    TagId            m_bulletTag             = 0;
+    std::unique_ptr<Broadphase>  m_broadphase;  // finds what each bullet might hit
+    std::array<std::vector<CollisionProxy>, LAYER_COUNT> m_layerProxies;  // collidables of each layer
+    std::vector<BroadphasePair>  m_collisionPairs;
+    SpazbitSystem                m_spazbits;  // jumps every spazbit in batches
+    TweenSystem                  m_tweens;    // animates component fields, one pass per tick
+    TimingWheel                  m_expiries;  // timed entities by the tick their lifespan runs out
+    Integrator                   m_integrator;  // moves the bouncing bodies with SIMD
+    std::vector<float>           m_radii;       // packed radii of the archetype being integrated
+    Narrowphase                  m_narrowphase;  // exact test over all candidate pairs at once
+    CollisionEventBuffer         m_collisionEvents;  // written by sCollision, read by sCollisionResponse
+    BatchRenderer                m_renderer;  // every shape in one draw call
     std::stringstream ssDebug;
 
     InterpolationType m_debugEasing = EASEIN_SINE;
-    void init(const std::string & config); // Initialize the game with a config file
+    void init(const std::string & config, const std::optional<HeadlessConfig> & headless); // Initialize the game with a config file
+    void runHeadless();
     void setPaused(bool paused);
 
     // System functions
@@ -54,15 +100,21 @@ class Game
     void sRender();
     void sGUI();
     void sEnemySpawner();
+    void simulate();
+    void sStorePrevious();
+    void sSpin();
     void sCollision();
+    void sCollisionResponse();
+    void collideLayers(CollisionLayer queryLayer, CollisionLayer targetLayer);
+    void setBroadphase(BroadphaseType type);
 
     void spawnPlayer();
-    void spawnEnemy (const std::string& type);
-    void spawnSmallEnemies (std::shared_ptr<Entity> const& e) ;
+    void spawnEnemy (TagId type);
+    void spawnSmallEnemies (EntityHandle e) ;
     void spawnBullet (const Vec2f & target);
-    void spawnSpecialWeapon(std::shared_ptr<Entity> entity);
-    void spazbitMovement(std::shared_ptr<Entity> entity);
-    std::shared_ptr<Entity> player();
+    void spawnSpecialWeapon(EntityHandle entity);
+    EntityHandle player() const;
+    void addLifespan(EntityHandle entity, int lifespan, InterpolationType easing);
 
     // Helper functions
     void parseConfig(const std::string & type, const std::string & values);
@@ -70,9 +122,10 @@ class Game
     void guiLogging() const;
     void guiSpawner();
     void guiEntityTable();
+    void guiMemory();
 
     // Add to Game.h in the private section
-    std::shared_ptr<Entity> createEntity(const std::string& tag,
+    EntityHandle createEntity(TagId tag,
                                         const Vec2f& position,
                                         int shapeRadius,
                                         size_t vertexCount,
@@ -87,6 +140,7 @@ class Game
 
 
 public:
-    explicit Game(const std::string & config);
+    /// headless, when given, overrides the Headless line of the config file
+    explicit Game(const std::string & config, const std::optional<HeadlessConfig> & headless = std::nullopt);
     void run();
 };
\ No newline at end of file
@@ -2,17 +2,54 @@
 #include "Game.h"
 #include "shapes/Shape.h"
 #include "vec2/Vec2.h"
+#include "benchmarks/Benchmarks.h"
 
+#include <charconv>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <functional>
+#include <optional>
 #include <vector>
 
-int main()
+namespace
 {
+    /// Parses a whole argument as a count of zero or more, nothing if it isn't one
+    std::optional<int> parseCount(const std::string& argument)
+    {
+        int value = 0;
+        const char* end = argument.data() + argument.size();
+        const auto [last, error] = std::from_chars(argument.data(), end, value);
+        if (error != std::errc() || last != end || value < 0) return std::nullopt;
+        return value;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // ./CMakeLearn --bench [names...] runs the headless benchmarks instead of the game
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        return benchmarks::run(std::vector<std::string>(argv + 2, argv + argc));
+    }
+
+    // ./CMakeLearn --headless [ticks] [ticks per second] simulates without a window,
+    // overriding the Headless line of the config
+    std::optional<HeadlessConfig> headless;
+    if (argc > 1 && std::string(argv[1]) == "--headless")
+    {
+        const auto ticks = argc > 2 ? parseCount(argv[2]) : 0;
+        const auto rate = argc > 3 ? parseCount(argv[3]) : 0;
+        if (!ticks || !rate || argc > 4)
+        {
+            std::cerr << "usage: " << argv[0] << " --headless [ticks] [ticks per second]" << std::endl;
+            return 1;
+        }
+        headless = HeadlessConfig{true, *ticks, *rate};
+    }
+
     const std::string configPath = "assets/bin/config.txt";
-    Game game(configPath);
+    Game game(configPath, headless);
     game.run();
     return 0;
 }
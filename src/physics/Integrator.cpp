@@ -0,0 +1,156 @@
+//
+// Created by Jorge Jimenez on 7/27/25.
+//
+
+#include "Integrator.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+static_assert(sizeof(Vec2f) == 2 * sizeof(float), "the kernels load a Vec2f as one packed (x, y) pair");
+
+namespace
+{
+#if SIMD_X86
+    /// Sign bit of a float, xor-ing it in negates the value exactly like *= -1 does
+    constexpr uint32_t SignBit = 0x80000000u;
+
+    /*
+     * Every kernel reflects and advances both axes the way Integrator::bounce() does:
+     *
+     *   out = (p - r < 0) | (p + r > max)
+     *   v   = out ? -v : v                  done by xor-ing the compare mask's sign bit
+     *   p   = p + v
+     */
+
+    /// (a.x, a.y, b.x, b.y), two bodies' pairs in one vector
+    SIMD_TARGET("sse2")
+    inline __m128 loadPairs(const Vec2f& a, const Vec2f& b)
+    {
+        const __m128 low = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&a));
+        return _mm_loadh_pi(low, reinterpret_cast<const __m64*>(&b));
+    }
+
+    SIMD_TARGET("sse2")
+    inline void storePairs(Vec2f& a, Vec2f& b, const __m128 pairs)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(&a), pairs);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(&b), pairs);
+    }
+
+    /// Reflects and advances the bodies whose (x, y) pairs sit side by side in p and v
+    SIMD_TARGET("sse2")
+    inline void bounceSse(__m128& p, __m128& v, const __m128 r, const __m128 max, const __m128 sign)
+    {
+        const __m128 out = _mm_or_ps(_mm_cmplt_ps(_mm_sub_ps(p, r), _mm_setzero_ps()),
+                                     _mm_cmpgt_ps(_mm_add_ps(p, r), max));
+        v = _mm_xor_ps(v, _mm_and_ps(out, sign));
+        p = _mm_add_ps(p, v);
+    }
+
+    SIMD_TARGET("sse2")
+    size_t integrateSse(CTransform* t, const float* r, const size_t count, const Vec2f bounds)
+    {
+        const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(SignBit)));
+        const __m128 max  = _mm_setr_ps(bounds.x, bounds.y, bounds.x, bounds.y);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            // each radius is needed by both lanes of its body
+            const __m128 r0 = _mm_loadu_ps(r + i);
+            const __m128 r1 = _mm_loadu_ps(r + i + 4);
+            __m128 radii[4] = { _mm_unpacklo_ps(r0, r0), _mm_unpackhi_ps(r0, r0),
+                                _mm_unpacklo_ps(r1, r1), _mm_unpackhi_ps(r1, r1) };
+
+            for (size_t k = 0; k < 4; k++)
+            {
+                CTransform& a = t[i + 2 * k];
+                CTransform& b = t[i + 2 * k + 1];
+                __m128 p = loadPairs(a.pos, b.pos);
+                __m128 v = loadPairs(a.velocity, b.velocity);
+                bounceSse(p, v, radii[k], max, sign);
+                storePairs(a.pos, b.pos, p);
+                storePairs(a.velocity, b.velocity, v);
+            }
+        }
+        return i;
+    }
+
+    /// Four bodies' (x, y) pairs in one vector
+    SIMD_TARGET("avx2")
+    inline __m256 loadPairs(const Vec2f& a, const Vec2f& b, const Vec2f& c, const Vec2f& d)
+    {
+        return _mm256_set_m128(loadPairs(c, d), loadPairs(a, b));
+    }
+
+    SIMD_TARGET("avx2")
+    inline void storePairs(Vec2f& a, Vec2f& b, Vec2f& c, Vec2f& d, const __m256 pairs)
+    {
+        storePairs(a, b, _mm256_castps256_ps128(pairs));
+        storePairs(c, d, _mm256_extractf128_ps(pairs, 1));
+    }
+
+    SIMD_TARGET("avx2")
+    size_t integrateAvx2(CTransform* t, const float* r, const size_t count, const Vec2f bounds)
+    {
+        const __m256 sign = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(SignBit)));
+        const __m256 max  = _mm256_setr_ps(bounds.x, bounds.y, bounds.x, bounds.y,
+                                           bounds.x, bounds.y, bounds.x, bounds.y);
+        // spreads radii 0-3 to (r0, r0, r1, r1, r2, r2, r3, r3)
+        const __m256i spread = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 r8 = _mm256_loadu_ps(r + i);
+            const __m256 radii[2] = { _mm256_permutevar8x32_ps(r8, spread),
+                                      _mm256_permutevar8x32_ps(_mm256_permute2f128_ps(r8, r8, 0x11), spread) };
+
+            for (size_t k = 0; k < 2; k++)
+            {
+                CTransform* q = t + i + 4 * k;
+                __m256 p = loadPairs(q[0].pos, q[1].pos, q[2].pos, q[3].pos);
+                __m256 v = loadPairs(q[0].velocity, q[1].velocity, q[2].velocity, q[3].velocity);
+
+                const __m256 out = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(p, radii[k]), _mm256_setzero_ps(), _CMP_LT_OQ),
+                                                _mm256_cmp_ps(_mm256_add_ps(p, radii[k]), max, _CMP_GT_OQ));
+                v = _mm256_xor_ps(v, _mm256_and_ps(out, sign));
+                p = _mm256_add_ps(p, v);
+
+                storePairs(q[0].pos, q[1].pos, q[2].pos, q[3].pos, p);
+                storePairs(q[0].velocity, q[1].velocity, q[2].velocity, q[3].velocity, v);
+            }
+        }
+        return i;
+    }
+#endif
+}
+
+void Integrator::run(const std::span<CTransform> transforms, const std::span<const float> radii, const Vec2f bounds) const
+{
+    assert(radii.size() == transforms.size() && "one radius per transform");
+
+    const size_t count = transforms.size();
+    CTransform* t = transforms.data();
+    const float* r = radii.data();
+
+    // the vector kernels stop at the last whole group of 8, the plain loop finishes the tail.
+    // The pairs are gathered with 64-bit loads, which 512-bit vectors don't make any faster
+    size_t done = 0;
+    switch (m_level)
+    {
+#if SIMD_X86
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:   done = integrateAvx2(t, r, count, bounds); break;
+        case SimdLevel::SSE:    done = integrateSse(t, r, count, bounds); break;
+#endif
+        default: break;
+    }
+    for (size_t i = done; i < count; i++) bounce(t[i], r[i], bounds);
+}
+
+void Integrator::setLevel(const SimdLevel level)
+{
+    m_level = std::min(level, simdLevel());
+}
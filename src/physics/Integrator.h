@@ -0,0 +1,70 @@
+//
+// Created by Jorge Jimenez on 7/27/25.
+//
+
+#pragma once
+
+#include "../components/Components.h"
+#include "../simd/Simd.h"
+#include "../vec2/Vec2.h"
+#include <span>
+
+/**
+ * @brief Vectorised bounce-and-advance over a column of transforms
+ *
+ * Moves the bodies straight inside an archetype's CTransform column. Each Vec2f is
+ * an (x, y) pair, so one 64-bit load brings in a whole position or velocity and a
+ * vector holds several bodies' pairs side by side, 8 bodies per loop iteration.
+ * The radii come from a packed array the caller fills first.
+ *
+ * A body touching an edge of the bounds has that velocity component negated with a
+ * compare and a sign flip instead of a branch, then every body advances by its
+ * velocity. Every kernel runs the same operations in the same order, so they all
+ * agree with bounce() bit for bit.
+ *
+ * Without a vector kernel, packing the radii costs more than the kernel saves, so
+ * callers should check level() and call bounce() on each body straight from its
+ * components instead.
+ *
+ * @example
+ * view.eachArchetype([&](Archetype& archetype) {
+ *     const auto transforms = archetype.column<CTransform>();
+ *     const auto shapes = archetype.column<CShape>();
+ *     if (integrator.level() == SimdLevel::Scalar) {
+ *         for (size_t i = 0; i < shapes.size(); i++) Integrator::bounce(transforms[i], shapes[i].radius, bounds);
+ *         return;
+ *     }
+ *     radii.resize(shapes.size());
+ *     for (size_t i = 0; i < shapes.size(); i++) radii[i] = shapes[i].radius;
+ *     integrator.run(transforms, radii, bounds);
+ * });
+ */
+class Integrator
+{
+    SimdLevel m_level = simdLevel();
+
+public:
+    /// Reflects one body off the edges of [0, bounds] and advances it one tick, the plain scalar loop
+    static void bounce(CTransform& transform, const float radius, const Vec2f bounds)
+    {
+        if (transform.pos.x - radius < 0 || transform.pos.x + radius > bounds.x) transform.velocity.x *= -1;
+        if (transform.pos.y - radius < 0 || transform.pos.y + radius > bounds.y) transform.velocity.y *= -1;
+        transform.pos.x += transform.velocity.x;
+        transform.pos.y += transform.velocity.y;
+    }
+
+    /**
+     * @brief Reflects every body off the edges of [0, bounds] and advances it one tick
+     *
+     * Transform i uses radii[i], the two spans must be the same size.
+     */
+    void run(std::span<CTransform> transforms, std::span<const float> radii, Vec2f bounds) const;
+
+    [[nodiscard]] SimdLevel level() const
+    {
+        return m_level;
+    }
+
+    /// Forces a narrower kernel, for benchmarks. Levels the CPU lacks are clamped
+    void setLevel(SimdLevel level);
+};
@@ -0,0 +1,214 @@
+//
+// Created by Jorge Jimenez on 8/6/25.
+//
+
+#include "BatchRenderer.h"
+#include "SinCos.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <thread>
+
+namespace
+{
+    sf::Color faded(sf::Color color, const float fade)
+    {
+        color.a = static_cast<uint8_t>(static_cast<float>(color.a) * fade + 0.5f);
+        return color;
+    }
+}
+
+uint32_t LevelOfDetail::points(const uint32_t exact, const float screenRadius, const float edgeScale) const
+{
+    if (fullRadius <= 0.0f || screenRadius >= fullRadius || exact <= minPoints) return exact;
+
+    const float perimeter = 2.0f * std::numbers::pi_v<float> * screenRadius;
+    const auto wanted = static_cast<uint32_t>(std::ceil(perimeter / (edgeLength * edgeScale)));
+    return std::clamp(wanted, minPoints, exact);
+}
+
+void BatchRenderer::writeShapes(const size_t begin, const size_t end)
+{
+    for (size_t k = begin; k < end; k++)
+    {
+        const Item& item = m_items[k];
+        const auto& corners = item.polygon->corners;
+        const size_t points = corners.size();
+        const float cosAngle = m_cosines[k];
+        const float sinAngle = m_sines[k];
+        const float radius = item.radius;
+        const float outer = item.outer;
+        const sf::Vector2f center = item.center;
+        const sf::Color fill = faded(item.fill, item.fade);
+        const sf::Color outline = faded(item.outline, item.fade);
+
+        // the unit polygon's corners, rotated by the shape's angle
+        const auto rotate = [&](const sf::Vector2f corner) {
+            return sf::Vector2f{ corner.x * cosAngle - corner.y * sinAngle, corner.x * sinAngle + corner.y * cosAngle };
+        };
+
+        sf::Vertex* out = m_vertices.data() + item.first;
+        sf::Vector2f d0 = rotate(corners[0]);
+        for (size_t i = 0; i < points; i++)
+        {
+            const sf::Vector2f d1 = rotate(corners[i + 1 < points ? i + 1 : 0]);
+
+            const sf::Vector2f p0{ center.x + d0.x * radius, center.y + d0.y * radius };
+            const sf::Vector2f p1{ center.x + d1.x * radius, center.y + d1.y * radius };
+            *out++ = { center, fill, {} };
+            *out++ = { p0, fill, {} };
+            *out++ = { p1, fill, {} };
+
+            if (item.outlined)
+            {
+                const sf::Vector2f q0{ center.x + d0.x * outer, center.y + d0.y * outer };
+                const sf::Vector2f q1{ center.x + d1.x * outer, center.y + d1.y * outer };
+                *out++ = { p0, outline, {} };
+                *out++ = { q0, outline, {} };
+                *out++ = { q1, outline, {} };
+                *out++ = { p0, outline, {} };
+                *out++ = { q1, outline, {} };
+                *out++ = { p1, outline, {} };
+            }
+
+            d0 = d1;
+        }
+    }
+}
+
+void BatchRenderer::build(EntityManager& entities, const float alpha)
+{
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    build(entities, alpha, { -infinity, -infinity }, { infinity, infinity }, 1.0f);
+}
+
+void BatchRenderer::build(EntityManager& entities, const float alpha, const sf::View& view, const float pixelsPerUnit)
+{
+    const sf::Vector2f half = view.getSize() / 2.0f;
+    build(entities, alpha, view.getCenter() - half, view.getCenter() + half, pixelsPerUnit);
+}
+
+void BatchRenderer::build(EntityManager& entities, const float alpha, const sf::Vector2f min, const sf::Vector2f max,
+                          const float pixelsPerUnit)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // 1) gather what every visible shape needs and where its vertices go, building any unit polygon not seen before
+    m_items.clear();
+    m_angles.clear();
+    uint32_t vertices = 0;
+    size_t culled = 0;
+    size_t reduced = 0;
+    entities.view<const CTransform, const CShape>().eachArchetype([&](Archetype& archetype) {
+        const auto transforms = archetype.column<CTransform>();
+        const auto shapes = archetype.column<CShape>();
+        const size_t first = m_items.size();
+
+        // timed shapes fade out over their lifespan, spazbits don't
+        const bool fading = m_lifespanTime && archetype.has<CLifespan>() && !archetype.has<CSpazJump>();
+        // the player is the shape everyone watches, it always keeps its exact point count
+        const bool exact = archetype.has<CInput>();
+        m_fadeRows.clear();
+
+        for (size_t row = 0; row < shapes.size(); row++)
+        {
+            const CTransform& transform = transforms[row];
+            const CShape& shape = shapes[row];
+            const uint32_t points = exact ? shape.points
+                                          : m_lod.points(shape.points, shape.radius * pixelsPerUnit, m_edgeScale);
+            const UnitPolygon& polygon = m_polygons.get(points);
+            const Vec2f position = transform.prevPos + (transform.pos - transform.prevPos) * alpha;
+            const bool outlined = shape.thickness != 0.0f;
+            const float outer = shape.radius + shape.thickness * polygon.miter;
+
+            const float reach = std::max(shape.radius, outer);
+            if (position.x + reach < min.x || position.x - reach > max.x ||
+                position.y + reach < min.y || position.y - reach > max.y)
+            {
+                culled++;
+                continue;
+            }
+
+            if (points < shape.points) reduced++;
+            m_items.push_back({ { position.x, position.y }, shape.radius, outer,
+                                shape.fill, shape.outline, &polygon, vertices, 1.0f, outlined });
+            // the short way round from the last tick's angle, so 359 to 0 turns one degree
+            float turn = transform.angle - transform.prevAngle;
+            if (turn > 180.0f) turn -= 360.0f;
+            else if (turn < -180.0f) turn += 360.0f;
+            m_angles.push_back(transform.prevAngle + turn * alpha);
+            if (fading) m_fadeRows.push_back(static_cast<uint32_t>(row));
+            vertices += static_cast<uint32_t>(polygon.corners.size() * (outlined ? 9 : 3));
+        }
+
+        if (!fading || m_fadeRows.empty()) return;
+
+        // how much of each lifespan is left at the time being drawn, eased in one batch per curve
+        const auto lifespans = archetype.column<CLifespan>();
+        m_fades.resize(m_fadeRows.size());
+        const auto progress = m_fades.in();
+        const auto curves = m_fades.curves();
+        for (size_t i = 0; i < m_fadeRows.size(); i++)
+        {
+            const CLifespan& lifespan = lifespans[m_fadeRows[i]];
+            progress[i] = std::clamp((static_cast<float>(lifespan.expiresAt) - *m_lifespanTime) /
+                                     static_cast<float>(lifespan.lifespan), 0.0f, 1.0f);
+            curves[i] = lifespan.getEasing();
+        }
+        m_fades.run();
+
+        // expo and elastic curves overshoot [0, 1]
+        const auto eased = m_fades.out();
+        for (size_t i = 0; i < m_fadeRows.size(); i++) m_items[first + i].fade = std::clamp(eased[i], 0.0f, 1.0f);
+    });
+    if (m_vertices.size() < vertices) m_vertices.resize(vertices);
+
+    // over budget, stretch the next frame's edges by about how far over it went, under it let them shrink back
+    const float edgeScale = m_edgeScale;
+    if (m_lod.vertexBudget > 0)
+    {
+        const float load = static_cast<float>(vertices) / static_cast<float>(m_lod.vertexBudget);
+        m_edgeScale = std::clamp(m_edgeScale * std::sqrt(load), 1.0f, MaxEdgeScale);
+    }
+
+    // 2) every rotation in one batch
+    m_sines.resize(m_angles.size());
+    m_cosines.resize(m_angles.size());
+    sinCosDegrees(m_angles, m_sines, m_cosines);
+
+    // 3) split the shapes into runs of about the same number of vertices, one per thread,
+    //    each writing its own range of the array
+    const size_t shapes = m_items.size();
+    const size_t hardware = m_threads > 0 ? m_threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads = std::clamp<size_t>(shapes / MinShapesPerThread, 1, hardware);
+
+    m_runs.resize(threads + 1);
+    m_runs[0] = 0;
+    for (size_t t = 1; t < threads; t++)
+    {
+        const uint32_t split = static_cast<uint32_t>(static_cast<uint64_t>(vertices) * t / threads);
+        m_runs[t] = std::lower_bound(m_items.begin() + static_cast<std::ptrdiff_t>(m_runs[t - 1]), m_items.end(), split,
+            [](const Item& item, const uint32_t first) { return item.first < first; }) - m_items.begin();
+    }
+    m_runs[threads] = shapes;
+    m_workers.run(threads, [this](const size_t t) { writeShapes(m_runs[t], m_runs[t + 1]); });
+
+    m_stats.shapes = shapes;
+    m_stats.culled = culled;
+    m_stats.reduced = reduced;
+    m_stats.edgeScale = edgeScale;
+    m_stats.vertices = vertices;
+    m_stats.threads = threads;
+    m_stats.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BatchRenderer::draw(sf::RenderTarget& target)
+{
+    m_stats.drawCalls = 0;
+    if (m_stats.vertices == 0) return;
+
+    target.draw(m_vertices.data(), m_stats.vertices, sf::PrimitiveType::Triangles);
+    m_stats.drawCalls = 1;
+}
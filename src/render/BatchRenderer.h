@@ -0,0 +1,183 @@
+//
+// Created by Jorge Jimenez on 8/6/25.
+//
+
+#pragma once
+
+#include "../entitymanager/EntityManager.h"
+#include "PolygonCache.h"
+#include "WorkerPool.h"
+#include "../systems/Systems.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Picks how many points a shape is drawn with from how big it is on screen
+ *
+ * Shapes at least fullRadius pixels across keep the point count their CShape asks for,
+ * so anything big enough to read as a triangle or a hexagon stays one. Smaller shapes
+ * get just enough points for edges of about edgeLength pixels, never fewer than
+ * minPoints and never more than they asked for, so a 20-point bullet a few pixels wide
+ * is drawn with a handful of edges. Shapes that asked for minPoints or fewer are left
+ * alone.
+ */
+struct LevelOfDetail
+{
+    float    fullRadius   = 0;  ///< On-screen radius in pixels from which point counts are exact, 0 turns LOD off
+    uint32_t minPoints    = 3;
+    float    edgeLength   = 6;  ///< On-screen edge length in pixels reduced shapes aim for
+    size_t   vertexBudget = 0;  ///< Vertices per frame above which edges are stretched, 0 for no budget
+
+    /// Points to draw a shape that asked for exact points with, at screenRadius pixels and edges stretched by edgeScale
+    [[nodiscard]] uint32_t points(uint32_t exact, float screenRadius, float edgeScale) const;
+};
+
+/**
+ * @brief Draws every shape in one draw call from a vertex array rebuilt each frame
+ *
+ * build() writes the fill and outline triangles of every entity with a transform and
+ * a shape into one reusable vertex array, in the order the view visits them, and draw()
+ * submits the whole array at once. Drawing an sf::CircleShape per entity costs one
+ * SFML draw, with its own state setup, per entity; this costs one per frame however
+ * many entities there are. The array keeps its capacity, so a steady frame doesn't
+ * allocate. Corners come from a PolygonCache, so a shape costs one rotation and a
+ * scale instead of a sin and cos per corner.
+ *
+ * Building runs in three steps: one pass over the view gathers each shape's position,
+ * colors and where its vertices start, the rotations of every shape are worked out in
+ * one SIMD batch, then the shapes are split into runs of about the same number of
+ * vertices and each run is written by its own thread into its own range of the array.
+ * The threads come from a WorkerPool kept for the renderer's lifetime, so a frame only
+ * wakes them. Small frames stay on the calling thread.
+ *
+ * Given the view being drawn through, build() drops every shape whose bounds, outline
+ * included, lie outside it while gathering, so culled shapes never get a rotation or
+ * a vertex. The gather has to read every transform anyway to interpolate it, and the
+ * view usually covers most of the world, so a bounds test there beats querying a grid
+ * that would have to be rebuilt from the same transforms first.
+ *
+ * Shapes with a CLifespan, spazbits aside, fade out as it runs down. The alpha is worked
+ * out per frame from setLifespanTime() and multiplied into the colors as the vertices
+ * are written, so the components are never touched.
+ *
+ * Point counts go through a LevelOfDetail, off unless setLevelOfDetail() is called.
+ * Shapes with a CInput, the player, always keep their exact point count whatever size.
+ * With a vertex budget, a frame that built more vertices than the budget stretches
+ * the edges of the next one, up to MaxEdgeScale, and a frame under it lets them shrink
+ * back. The budget only pushes toward fewer vertices: shapes at or above fullRadius and
+ * shapes already down to minPoints can't shrink, so a scene dense enough stays over it.
+ *
+ * build() only does CPU work and times itself, so it can be measured headless.
+ *
+ * @example
+ * renderer.setLevelOfDetail({ 12.0f, 4, 10.0f, 300000 });
+ * renderer.build(entities, renderAlpha, window.getView(), pixelsPerUnit);
+ * renderer.draw(window);
+ * ImGui::Text("%.2f ms", renderer.stats().buildMs);
+ */
+class BatchRenderer
+{
+public:
+    struct Stats
+    {
+        double buildMs   = 0;  ///< Time the last build() took
+        size_t shapes    = 0;  ///< Shapes drawn
+        size_t culled    = 0;  ///< Shapes left out for being outside the view
+        size_t vertices  = 0;
+        size_t drawCalls = 0;  ///< Draws the last draw() submitted
+        size_t threads   = 0;  ///< Threads the last build() wrote vertices on
+        size_t reduced   = 0;  ///< Shapes drawn with fewer points than they asked for
+        float  edgeScale = 1;  ///< How far the vertex budget stretched the edges
+    };
+
+    /// Most the vertex budget stretches edges by
+    static constexpr float MaxEdgeScale = 4.0f;
+
+    /// Fewest shapes worth handing to another thread
+    static constexpr size_t MinShapesPerThread = 2048;
+
+    /**
+     * @brief Rebuilds the vertex array from every entity with a CTransform and a CShape
+     *
+     * Positions are drawn alpha of the way from prevPos to pos, and angles from prevAngle
+     * to angle, like the fixed timestep expects. Every shape is drawn, wherever it is.
+     */
+    void build(EntityManager& entities, float alpha);
+
+    /**
+     * @brief Same as build(entities, alpha), leaving out the shapes outside an unrotated view
+     *
+     * @param pixelsPerUnit Screen pixels per world unit the view is drawn at, for picking point counts
+     */
+    void build(EntityManager& entities, float alpha, const sf::View& view, float pixelsPerUnit = 1.0f);
+
+    /// Submits everything built since the last build(), in one draw call
+    void draw(sf::RenderTarget& target);
+
+    [[nodiscard]] const Stats& stats() const
+    {
+        return m_stats;
+    }
+
+    [[nodiscard]] const std::vector<sf::Vertex>& vertices() const
+    {
+        return m_vertices;
+    }
+
+    void setLevelOfDetail(const LevelOfDetail& lod)
+    {
+        m_lod = lod;
+        m_edgeScale = 1.0f;
+    }
+
+    /// Lifespan tick the next build() draws at, between ticks, or nothing to draw without fading
+    void setLifespanTime(const std::optional<float> now)
+    {
+        m_lifespanTime = now;
+    }
+
+    /// Most threads build() may write on, 0 for one per hardware thread
+    void setThreads(const unsigned threads)
+    {
+        m_threads = threads;
+    }
+
+private:
+    /// One shape's share of the frame, gathered before any vertex is written
+    struct Item
+    {
+        sf::Vector2f       center;
+        float              radius = 0;
+        float              outer  = 0;  ///< Radius of the outline's outer corners
+        sf::Color          fill;
+        sf::Color          outline;
+        const UnitPolygon* polygon = nullptr;
+        uint32_t           first   = 0;  ///< Index of its first vertex
+        float              fade    = 1;  ///< Multiplies the alpha of both colors
+        bool               outlined = false;
+    };
+
+    std::vector<sf::Vertex> m_vertices;
+    std::vector<Item>       m_items;
+    std::vector<float>      m_angles;
+    std::vector<float>      m_sines;
+    std::vector<float>      m_cosines;
+    std::vector<size_t>     m_runs;      ///< Run t of the threaded write covers items [m_runs[t], m_runs[t + 1])
+    std::vector<uint32_t>   m_fadeRows;  ///< Rows of the archetype being gathered whose shape is drawn
+    EasingBuckets           m_fades;
+    std::optional<float>    m_lifespanTime;
+    PolygonCache            m_polygons;
+    LevelOfDetail           m_lod;
+    Stats                   m_stats;
+    float                   m_edgeScale = 1.0f;
+    unsigned                m_threads   = 0;
+    WorkerPool              m_workers;
+
+    /// Gathers the shapes overlapping [min, max] and writes their vertices
+    void build(EntityManager& entities, float alpha, sf::Vector2f min, sf::Vector2f max, float pixelsPerUnit);
+
+    /// Writes the vertices of items [begin, end), safe to run on several threads at once for disjoint ranges
+    void writeShapes(size_t begin, size_t end);
+};
@@ -0,0 +1,26 @@
+//
+// Created by Jorge Jimenez on 8/8/25.
+//
+
+#include "PolygonCache.h"
+#include <cmath>
+#include <numbers>
+
+const UnitPolygon& PolygonCache::get(const size_t points)
+{
+    if (points >= m_polygons.size()) m_polygons.resize(points + 1);
+
+    UnitPolygon& polygon = m_polygons[points];
+    if (polygon.corners.size() == points) return polygon;
+
+    // the same angles sf::CircleShape::getPoint uses, in double so every count is as exact as a float gets
+    constexpr double Pi = std::numbers::pi;
+    polygon.corners.resize(points);
+    for (size_t i = 0; i < points; i++)
+    {
+        const double angle = 2.0 * Pi * static_cast<double>(i) / static_cast<double>(points) - Pi / 2.0;
+        polygon.corners[i] = { static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)) };
+    }
+    polygon.miter = points > 2 ? static_cast<float>(1.0 / std::cos(Pi / static_cast<double>(points))) : 1.0f;
+    return polygon;
+}
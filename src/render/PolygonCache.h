@@ -0,0 +1,43 @@
+//
+// Created by Jorge Jimenez on 8/8/25.
+//
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Corners of a regular polygon with radius 1, laid out like sf::CircleShape's
+ *
+ * Corner i sits at i / points of a turn clockwise from the top. The outline of a polygon
+ * grows outwards with mitred corners, which puts its outer corners miter times the
+ * outline thickness further out than the inner ones.
+ */
+struct UnitPolygon
+{
+    std::vector<sf::Vector2f> corners;
+    float                     miter = 1;
+};
+
+/**
+ * @brief Builds each unit polygon the first time its point count is asked for, then shares it
+ *
+ * Every shape with the same point count is drawn from the same corners, scaled by its
+ * radius and rotated by its angle, so the sines and cosines are worked out once per
+ * point count for the whole game instead of once per corner per shape per frame.
+ * References returned by get() stay valid as more point counts are added.
+ *
+ * @example
+ * const UnitPolygon& hexagon = polygons.get(6);
+ * for (const auto& corner : hexagon.corners) { ... center + corner * radius ... }
+ */
+class PolygonCache
+{
+    std::deque<UnitPolygon> m_polygons;  ///< Indexed by point count, empty until first asked for
+
+public:
+    [[nodiscard]] const UnitPolygon& get(size_t points);
+};
@@ -0,0 +1,155 @@
+//
+// Created by Jorge Jimenez on 8/10/25.
+//
+
+#include "SinCos.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace
+{
+    /*
+     * Every kernel runs the same steps:
+     *
+     *   q = round(degrees / 90)           adding and subtracting 1.5 * 2^23 rounds to nearest even
+     *   y = (degrees - q * 90) * pi / 180 within pi / 4 of zero
+     *   s, c = sin(y), cos(y)             minimax polynomials
+     *   q odd        swaps s and c
+     *   q & 2        negates the sine, (q + 1) & 2 negates the cosine
+     */
+    constexpr float Round      = 12582912.0f;  // 1.5 * 2^23
+    constexpr float InvQuarter = 1.0f / 90.0f;
+    constexpr float Quarter    = 90.0f;
+    constexpr float ToRadians  = 0.01745329251994329577f;
+    constexpr float S1 = -1.6666654611e-1f;
+    constexpr float S2 =  8.3321608736e-3f;
+    constexpr float S3 = -1.9515295891e-4f;
+    constexpr float C1 =  4.166664568298827e-2f;
+    constexpr float C2 = -1.388731625493765e-3f;
+    constexpr float C3 =  2.443315711809948e-5f;
+
+    /// Angles are clamped to this first, past it the rounding trick runs out of bits
+    constexpr float MaxDegrees = 4194304.0f;  // 2^22
+
+    void sinCosScalar(const float* degrees, float* sines, float* cosines, const size_t begin, const size_t count)
+    {
+        for (size_t i = begin; i < count; i++)
+        {
+            const float d = std::clamp(degrees[i], -MaxDegrees, MaxDegrees);
+            const float q = (d * InvQuarter + Round) - Round;
+            const float y = (d - q * Quarter) * ToRadians;
+            const float z = y * y;
+
+            const float s = y + y * z * (S1 + z * (S2 + z * S3));
+            const float c = 1.0f - 0.5f * z + z * z * (C1 + z * (C2 + z * C3));
+
+            const auto quadrant = static_cast<uint32_t>(static_cast<int32_t>(q));
+            const bool swap = (quadrant & 1u) != 0;
+            const uint32_t sineSign = (quadrant & 2u) << 30;
+            const uint32_t cosineSign = ((quadrant + 1u) & 2u) << 30;
+
+            sines[i]   = std::bit_cast<float>(std::bit_cast<uint32_t>(swap ? c : s) ^ sineSign);
+            cosines[i] = std::bit_cast<float>(std::bit_cast<uint32_t>(swap ? s : c) ^ cosineSign);
+        }
+    }
+
+#if SIMD_X86
+    SIMD_TARGET("sse2")
+    size_t sinCosSse(const float* degrees, float* sines, float* cosines, const size_t count)
+    {
+        const __m128 max = _mm_set1_ps(MaxDegrees);
+        const __m128 min = _mm_set1_ps(-MaxDegrees);
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i two = _mm_set1_epi32(2);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            // min then max gives what std::clamp does for every angle that isn't NaN
+            const __m128 d = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(degrees + i), max), min);
+            const __m128 q = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(d, _mm_set1_ps(InvQuarter)), _mm_set1_ps(Round)),
+                                        _mm_set1_ps(Round));
+            const __m128 y = _mm_mul_ps(_mm_sub_ps(d, _mm_mul_ps(q, _mm_set1_ps(Quarter))), _mm_set1_ps(ToRadians));
+            const __m128 z = _mm_mul_ps(y, y);
+
+            const __m128 sPoly = _mm_add_ps(_mm_set1_ps(S1), _mm_mul_ps(z, _mm_add_ps(_mm_set1_ps(S2),
+                                                                        _mm_mul_ps(z, _mm_set1_ps(S3)))));
+            const __m128 s = _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(y, z), sPoly));
+            const __m128 cPoly = _mm_add_ps(_mm_set1_ps(C1), _mm_mul_ps(z, _mm_add_ps(_mm_set1_ps(C2),
+                                                                        _mm_mul_ps(z, _mm_set1_ps(C3)))));
+            const __m128 c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)),
+                                        _mm_mul_ps(_mm_mul_ps(z, z), cPoly));
+
+            const __m128i quadrant = _mm_cvttps_epi32(q);
+            const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+            const __m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+            const __m128 cosineSign = _mm_castsi128_ps(
+                _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+
+            const __m128 sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+            const __m128 cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+            _mm_storeu_ps(sines + i, _mm_xor_ps(sine, sineSign));
+            _mm_storeu_ps(cosines + i, _mm_xor_ps(cosine, cosineSign));
+        }
+        return i;
+    }
+
+    SIMD_TARGET("avx2")
+    size_t sinCosAvx2(const float* degrees, float* sines, float* cosines, const size_t count)
+    {
+        const __m256 max = _mm256_set1_ps(MaxDegrees);
+        const __m256 min = _mm256_set1_ps(-MaxDegrees);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i two = _mm256_set1_epi32(2);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 d = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(degrees + i), max), min);
+            const __m256 q = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(d, _mm256_set1_ps(InvQuarter)),
+                                                         _mm256_set1_ps(Round)), _mm256_set1_ps(Round));
+            const __m256 y = _mm256_mul_ps(_mm256_sub_ps(d, _mm256_mul_ps(q, _mm256_set1_ps(Quarter))),
+                                           _mm256_set1_ps(ToRadians));
+            const __m256 z = _mm256_mul_ps(y, y);
+
+            const __m256 sPoly = _mm256_add_ps(_mm256_set1_ps(S1), _mm256_mul_ps(z,
+                _mm256_add_ps(_mm256_set1_ps(S2), _mm256_mul_ps(z, _mm256_set1_ps(S3)))));
+            const __m256 s = _mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(y, z), sPoly));
+            const __m256 cPoly = _mm256_add_ps(_mm256_set1_ps(C1), _mm256_mul_ps(z,
+                _mm256_add_ps(_mm256_set1_ps(C2), _mm256_mul_ps(z, _mm256_set1_ps(C3)))));
+            const __m256 c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)),
+                                           _mm256_mul_ps(_mm256_mul_ps(z, z), cPoly));
+
+            const __m256i quadrant = _mm256_cvttps_epi32(q);
+            const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+            const __m256 sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+            const __m256 cosineSign = _mm256_castsi256_ps(
+                _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+
+            _mm256_storeu_ps(sines + i, _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sineSign));
+            _mm256_storeu_ps(cosines + i, _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosineSign));
+        }
+        return i;
+    }
+#endif
+}
+
+void sinCosDegrees(const std::span<const float> degrees, const std::span<float> sines, const std::span<float> cosines,
+                   const SimdLevel level)
+{
+    const size_t count = std::min({ degrees.size(), sines.size(), cosines.size() });
+
+    // the vector kernels stop at the last whole vector, the scalar kernel finishes the tail
+    size_t done = 0;
+    switch (std::min(level, simdLevel()))
+    {
+#if SIMD_X86
+        case SimdLevel::AVX512:
+        case SimdLevel::AVX2:   done = sinCosAvx2(degrees.data(), sines.data(), cosines.data(), count); break;
+        case SimdLevel::SSE:    done = sinCosSse(degrees.data(), sines.data(), cosines.data(), count); break;
+#endif
+        default: break;
+    }
+    sinCosScalar(degrees.data(), sines.data(), cosines.data(), done, count);
+}
@@ -0,0 +1,24 @@
+//
+// Created by Jorge Jimenez on 8/10/25.
+//
+
+#pragma once
+
+#include "../simd/Simd.h"
+#include <span>
+
+/**
+ * @brief Sine and cosine of a batch of angles in degrees, several angles per instruction
+ *
+ * Each angle is reduced to the nearest multiple of 90 degrees plus a remainder within
+ * 45 degrees of it, the remainder goes through short sine and cosine polynomials, and
+ * the quadrant swaps and negates the results. That is accurate to a few float ulps,
+ * plenty for placing vertices, and every kernel runs the same operations in the same
+ * order, so they all agree with the scalar kernel bit for bit.
+ *
+ * @example
+ * sinCosDegrees(angles, sines, cosines);
+ * const Vec2f rotated(x * cosines[i] - y * sines[i], x * sines[i] + y * cosines[i]);
+ */
+void sinCosDegrees(std::span<const float> degrees, std::span<float> sines, std::span<float> cosines,
+                   SimdLevel level = simdLevel());
@@ -0,0 +1,59 @@
+//
+// Created by Jorge Jimenez on 8/10/25.
+//
+
+#include "WorkerPool.h"
+
+void WorkerPool::run(const size_t tasks, const std::function<void(size_t)>& task)
+{
+    if (tasks == 0) return;
+
+    if (tasks > 1)
+    {
+        while (m_threads.size() < tasks - 1)
+        {
+            const size_t index = m_threads.size();
+            m_threads.emplace_back([this, index](const std::stop_token stop) { work(stop, index); });
+        }
+
+        {
+            const std::lock_guard lock(m_mutex);
+            m_task = &task;
+            m_tasks = tasks;
+            m_remaining = tasks - 1;
+            m_generation++;
+        }
+        m_wake.notify_all();
+    }
+
+    task(0);
+
+    if (tasks > 1)
+    {
+        std::unique_lock lock(m_mutex);
+        m_finished.wait(lock, [this] { return m_remaining == 0; });
+        m_task = nullptr;
+    }
+}
+
+void WorkerPool::work(const std::stop_token stop, const size_t index)
+{
+    // a worker started mid-run still takes its task from that run
+    uint64_t seen = 0;
+    std::unique_lock lock(m_mutex);
+    while (true)
+    {
+        if (!m_wake.wait(lock, stop, [&] { return m_generation != seen; })) return;
+        seen = m_generation;
+
+        // worker i runs task i + 1, runs with fewer tasks leave it idle
+        if (index + 1 >= m_tasks) continue;
+
+        const auto* task = m_task;
+        lock.unlock();
+        (*task)(index + 1);
+        lock.lock();
+
+        if (--m_remaining == 0) m_finished.notify_one();
+    }
+}
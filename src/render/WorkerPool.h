@@ -0,0 +1,53 @@
+//
+// Created by Jorge Jimenez on 8/10/25.
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Threads kept alive between frames, for splitting one job into parallel tasks
+ *
+ * run() hands task i to worker i - 1, does task 0 on the calling thread and returns
+ * once every task is done. Workers sleep on a condition variable between runs, so a
+ * frame pays a wake-up instead of starting and joining threads. Workers are only
+ * started when a run needs more than there are, so steady frames don't allocate.
+ * Destroying the pool stops and joins them.
+ *
+ * @example
+ * pool.run(ranges.size(), [&](size_t i) { write(ranges[i]); });
+ */
+class WorkerPool
+{
+public:
+    /// Calls task(i) for every i in [0, tasks), in parallel, returning once all have finished
+    void run(size_t tasks, const std::function<void(size_t)>& task);
+
+    /// Workers started so far, besides the calling thread
+    [[nodiscard]] size_t size() const
+    {
+        return m_threads.size();
+    }
+
+private:
+    std::mutex                         m_mutex;
+    std::condition_variable_any        m_wake;
+    std::condition_variable            m_finished;
+    const std::function<void(size_t)>* m_task       = nullptr;
+    uint64_t                           m_generation = 0;  ///< Bumped by every run(), wakes the workers
+    size_t                             m_tasks      = 0;
+    size_t                             m_remaining  = 0;  ///< Tasks of this run still running on workers
+
+    // declared last so the threads are stopped and joined before anything they use goes away
+    std::vector<std::jthread> m_threads;
+
+    void work(std::stop_token stop, size_t index);
+};
@@ -0,0 +1,57 @@
+//
+// Created by Jorge Jimenez on 7/20/25.
+//
+
+#include "Simd.h"
+
+#if SIMD_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    SimdLevel detect()
+    {
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2"))    return SimdLevel::SSE;
+        return SimdLevel::Scalar;
+#elif SIMD_X86 && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool sse2    = (info[3] & (1 << 26)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave) return sse2 ? SimdLevel::SSE : SimdLevel::Scalar;
+
+        // the OS has to save the wider registers on context switches too
+        const unsigned long long xcr0 = _xgetbv(0);
+        const bool ymmSaved = (xcr0 & 0x6) == 0x6;
+        const bool zmmSaved = (xcr0 & 0xe6) == 0xe6;
+
+        bool avx2 = false, avx512 = false;
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            avx2   = (info[1] & (1 << 5)) != 0;
+            avx512 = (info[1] & (1 << 16)) != 0;
+        }
+
+        if (avx512 && zmmSaved) return SimdLevel::AVX512;
+        if (avx2 && ymmSaved)   return SimdLevel::AVX2;
+        return sse2 ? SimdLevel::SSE : SimdLevel::Scalar;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+}
+
+SimdLevel simdLevel()
+{
+    static const SimdLevel level = detect();
+    return level;
+}
@@ -0,0 +1,57 @@
+//
+// Created by Jorge Jimenez on 7/20/25.
+//
+
+#pragma once
+
+/**
+ * @brief Runtime CPU feature detection shared by the SIMD kernels
+ *
+ * Kernels are compiled for every instruction set up front and the fastest one the
+ * running CPU supports is picked at runtime, so one binary runs everywhere without
+ * raising the compiler's baseline flags.
+ *
+ * x86 kernels go inside `#if SIMD_X86` and are tagged with SIMD_TARGET so GCC and
+ * Clang emit the wider instructions for that function only. MSVC needs no tag. On
+ * other architectures, like macOS on ARM, only the scalar kernels are built.
+ *
+ * @example
+ * #if SIMD_X86
+ * SIMD_TARGET("avx2") void kernelAvx2(...) { ... _mm256_add_ps(...) ... }
+ * #endif
+ *
+ * if (simdLevel() >= SimdLevel::AVX2) kernelAvx2(...); else kernelScalar(...);
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SIMD_X86 1
+    #include <immintrin.h>
+#else
+    #define SIMD_X86 0
+#endif
+
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define SIMD_TARGET(isa)
+#endif
+
+/// Instruction sets the kernels are written for, from narrowest to widest
+enum class SimdLevel
+{
+    Scalar,
+    SSE,    ///< 4 floats per instruction
+    AVX2,   ///< 8 floats per instruction
+    AVX512, ///< 16 floats per instruction
+};
+
+/// Display names, in the same order as SimdLevel
+inline constexpr const char* SimdLevelNames[] = {
+    "scalar",
+    "SSE",
+    "AVX2",
+    "AVX-512",
+};
+
+/// Widest instruction set the CPU and OS support, detected once
+SimdLevel simdLevel();
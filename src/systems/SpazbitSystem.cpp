@@ -0,0 +1,77 @@
+//
+// Created by Jorge Jimenez on 7/29/25.
+//
+
+#include "SpazbitSystem.h"
+#include <algorithm>
+#include <numbers>
+
+void SpazbitSystem::update(const std::span<CTransform> transforms, const std::span<CSpazJump> jumps,
+                           const std::span<const CShape> shapes, const std::span<const CLifespan> lifespans,
+                           const Params& params)
+{
+    const size_t count = jumps.size();
+
+    // 1) restart every finished jump, drawing all of their random numbers in one go
+    m_finished.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (jumps[i].distanceTraveled >= jumps[i].distanceToTravel) m_finished.push_back(static_cast<uint32_t>(i));
+    }
+
+    m_random.resize(m_finished.size() * 3);
+    for (float& u : m_random)
+    {
+        // the top 24 bits of the generator, exactly representable as a float in [0, 1)
+        u = static_cast<float>(m_rng() >> 8) * 0x1p-24f;
+    }
+
+    for (size_t k = 0; k < m_finished.size(); k++)
+    {
+        const uint32_t i = m_finished[k];
+        const float angle    = m_random[3 * k] * 2.0f * std::numbers::pi_v<float>;
+        const float speed    = params.minSpeed + m_random[3 * k + 1] * (params.maxSpeed - params.minSpeed);
+        const float distance = params.minDistance + m_random[3 * k + 2] * (params.maxDistance - params.minDistance);
+
+        transforms[i].velocity = Vec2f{ std::cos(angle) * speed, std::sin(angle) * speed };
+        jumps[i].distanceToTravel = distance;
+        jumps[i].distanceTraveled = 0.0f;
+    }
+
+    // 2) ease every jump's progress, one batch per curve
+    m_easing.resize(count);
+    const auto progress = m_easing.in();
+    const auto curves = m_easing.curves();
+    for (size_t i = 0; i < count; i++)
+    {
+        progress[i] = jumps[i].distanceToTravel > 0.0f
+            ? std::clamp(jumps[i].distanceTraveled / jumps[i].distanceToTravel, 0.0f, 1.0f)
+            : 1.0f;
+        curves[i] = lifespans[i].getEasing();
+    }
+    m_easing.run();
+    const auto eased = m_easing.out();
+
+    // 3) move and bounce, clamping back inside so a spazbit can't get stuck outside
+    const Vec2f bounds = params.bounds;
+    for (size_t i = 0; i < count; i++)
+    {
+        CTransform& transform = transforms[i];
+        const float r = shapes[i].getRadius();
+
+        transform.pos += transform.velocity * eased[i];
+
+        if (transform.pos.x - r < 0.0f || transform.pos.x + r > bounds.x)
+        {
+            transform.velocity.x = -transform.velocity.x;
+            transform.pos.x = std::clamp(transform.pos.x, r, bounds.x - r);
+        }
+        if (transform.pos.y - r < 0.0f || transform.pos.y + r > bounds.y)
+        {
+            transform.velocity.y = -transform.velocity.y;
+            transform.pos.y = std::clamp(transform.pos.y, r, bounds.y - r);
+        }
+
+        jumps[i].distanceTraveled += 1.0f;
+    }
+}
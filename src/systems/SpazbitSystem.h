@@ -0,0 +1,60 @@
+//
+// Created by Jorge Jimenez on 7/29/25.
+//
+
+#pragma once
+
+#include "Systems.h"
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Moves spazbits in eased jumps, a whole archetype's worth at a time
+ *
+ * Each spazbit jumps in a random direction for a random distance, eased by its
+ * lifespan's curve, and bounces off the window edges. Instead of looking every
+ * component up per entity, update() takes the archetype's columns and runs each step
+ * over all of them: finished jumps are restarted with random numbers drawn in one
+ * batch, progress is eased in one batch per curve, then everything moves and
+ * bounces.
+ *
+ * @example
+ * view.eachArchetype([&](Archetype& archetype) {
+ *     spazbits.update(archetype.column<CTransform>(), archetype.column<CSpazJump>(),
+ *                     archetype.column<CShape>(), archetype.column<CLifespan>(), params);
+ * });
+ */
+class SpazbitSystem : Systems
+{
+    std::mt19937          m_rng{ std::random_device{}() };
+    std::vector<uint32_t> m_finished;  ///< Rows whose jump ended last tick
+    std::vector<float>    m_random;    ///< Three uniform [0, 1) numbers per finished jump
+    EasingBuckets         m_easing;
+
+public:
+    /// Ranges the jumps are drawn from and the area they bounce around in
+    struct Params
+    {
+        Vec2f bounds;
+        float minSpeed = 0;
+        float maxSpeed = 0;
+        float minDistance = 50;
+        float maxDistance = 200;
+    };
+
+    /**
+     * @brief Advances every spazbit of one archetype by a tick
+     *
+     * The spans are the archetype's columns, so row i of each describes the same spazbit.
+     */
+    void update(std::span<CTransform> transforms, std::span<CSpazJump> jumps,
+                std::span<const CShape> shapes, std::span<const CLifespan> lifespans, const Params& params);
+
+    /// Makes the jumps repeatable, for benchmarks
+    void seed(uint32_t seed)
+    {
+        m_rng.seed(seed);
+    }
+};
@@ -3,3 +3,245 @@
 //
 
 #include "Systems.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    /**
+     * @brief One easing curve sampled at LutSize + 1 evenly spaced points
+     *
+     * The end samples hold the curve's limits just inside [0, 1]. Some curves are
+     * defined separately at exactly 0 and 1 (easeinExpo jumps from 0 to ~1 right
+     * after 0), so those two values are kept aside and patched in when t hits them.
+     * The extra last sample lets t == 1 read one past the end without a bounds check.
+     */
+    struct EasingTable
+    {
+        std::array<float, Interpolate::LutSize + 2> samples{};
+        float atZero = 0;
+        float atOne  = 1;
+    };
+
+    const std::array<EasingTable, INTERPOLATION_COUNT>& easingTables()
+    {
+        static const auto tables = [] {
+            std::array<EasingTable, INTERPOLATION_COUNT> result;
+            Interpolate exact;
+            for (int curve = 0; curve < INTERPOLATION_COUNT; curve++)
+            {
+                const auto type = static_cast<InterpolationType>(curve);
+                EasingTable& table = result[curve];
+                for (size_t k = 0; k <= Interpolate::LutSize; k++)
+                {
+                    float t = static_cast<float>(k) / Interpolate::LutSize;
+                    if (k == 0) t = std::nextafter(0.0f, 1.0f);
+                    if (k == Interpolate::LutSize) t = std::nextafter(1.0f, 0.0f);
+                    table.samples[k] = exact.interpolate(t, type);
+                }
+                table.samples[Interpolate::LutSize + 1] = table.samples[Interpolate::LutSize];
+                table.atZero = exact.interpolate(0.0f, type);
+                table.atOne  = exact.interpolate(1.0f, type);
+            }
+            return result;
+        }();
+        return tables;
+    }
+
+    constexpr auto Scale = static_cast<float>(Interpolate::LutSize);
+
+    /*
+     * Every kernel runs the same steps:
+     *
+     *   c = clamp(t, 0, 1)
+     *   x = c * LutSize,  i = (int)x,  f = x - i
+     *   v = s[i] + (s[i + 1] - s[i]) * f
+     *   v = atZero when c == 0, atOne when c == 1
+     */
+    void lookupScalar(const EasingTable& table, const float* in, float* out, const size_t begin, const size_t count)
+    {
+        const float* s = table.samples.data();
+        for (size_t k = begin; k < count; k++)
+        {
+            const float c = std::min(std::max(in[k], 0.0f), 1.0f);
+            const float x = c * Scale;
+            const int   i = static_cast<int>(x);
+            const float f = x - static_cast<float>(i);
+            const float v = s[i] + (s[i + 1] - s[i]) * f;
+            out[k] = c == 0.0f ? table.atZero : c == 1.0f ? table.atOne : v;
+        }
+    }
+
+#if SIMD_X86
+    SIMD_TARGET("sse2")
+    size_t lookupSse(const EasingTable& table, const float* in, float* out, const size_t count)
+    {
+        const float* s = table.samples.data();
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(Scale);
+        const __m128 atZero = _mm_set1_ps(table.atZero);
+        const __m128 atOne = _mm_set1_ps(table.atOne);
+
+        size_t k = 0;
+        for (; k + 4 <= count; k += 4)
+        {
+            const __m128 c = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + k), zero), one);
+            const __m128 x = _mm_mul_ps(c, scale);
+            const __m128i i = _mm_cvttps_epi32(x);
+            const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+
+            // SSE has no gather, so the four samples are loaded one by one
+            alignas(16) int idx[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(idx), i);
+            const __m128 a = _mm_setr_ps(s[idx[0]], s[idx[1]], s[idx[2]], s[idx[3]]);
+            const __m128 b = _mm_setr_ps(s[idx[0] + 1], s[idx[1] + 1], s[idx[2] + 1], s[idx[3] + 1]);
+            __m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f));
+
+            // select without blendv, which is SSE4.1
+            const __m128 isZero = _mm_cmpeq_ps(c, zero);
+            const __m128 isOne = _mm_cmpeq_ps(c, one);
+            v = _mm_or_ps(_mm_andnot_ps(isZero, v), _mm_and_ps(isZero, atZero));
+            v = _mm_or_ps(_mm_andnot_ps(isOne, v), _mm_and_ps(isOne, atOne));
+            _mm_storeu_ps(out + k, v);
+        }
+        return k;
+    }
+
+    SIMD_TARGET("avx2")
+    size_t lookupAvx2(const EasingTable& table, const float* in, float* out, const size_t count)
+    {
+        const float* s = table.samples.data();
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 scale = _mm256_set1_ps(Scale);
+        const __m256 atZero = _mm256_set1_ps(table.atZero);
+        const __m256 atOne = _mm256_set1_ps(table.atOne);
+
+        size_t k = 0;
+        for (; k + 8 <= count; k += 8)
+        {
+            const __m256 c = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + k), zero), one);
+            const __m256 x = _mm256_mul_ps(c, scale);
+            const __m256i i = _mm256_cvttps_epi32(x);
+            const __m256 f = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+
+            const __m256 a = _mm256_i32gather_ps(s, i, 4);
+            const __m256 b = _mm256_i32gather_ps(s + 1, i, 4);
+            __m256 v = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), f));
+
+            v = _mm256_blendv_ps(v, atZero, _mm256_cmp_ps(c, zero, _CMP_EQ_OQ));
+            v = _mm256_blendv_ps(v, atOne, _mm256_cmp_ps(c, one, _CMP_EQ_OQ));
+            _mm256_storeu_ps(out + k, v);
+        }
+        return k;
+    }
+
+    SIMD_TARGET("avx512f")
+    size_t lookupAvx512(const EasingTable& table, const float* in, float* out, const size_t count)
+    {
+        const float* s = table.samples.data();
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512 one = _mm512_set1_ps(1.0f);
+        const __m512 scale = _mm512_set1_ps(Scale);
+        const __m512 atZero = _mm512_set1_ps(table.atZero);
+        const __m512 atOne = _mm512_set1_ps(table.atOne);
+
+        size_t k = 0;
+        for (; k + 16 <= count; k += 16)
+        {
+            const __m512 c = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(in + k), zero), one);
+            const __m512 x = _mm512_mul_ps(c, scale);
+            const __m512i i = _mm512_cvttps_epi32(x);
+            const __m512 f = _mm512_sub_ps(x, _mm512_cvtepi32_ps(i));
+
+            const __m512 a = _mm512_i32gather_ps(i, s, 4);
+            const __m512 b = _mm512_i32gather_ps(i, s + 1, 4);
+            __m512 v = _mm512_add_ps(a, _mm512_mul_ps(_mm512_sub_ps(b, a), f));
+
+            v = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(c, zero, _CMP_EQ_OQ), v, atZero);
+            v = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(c, one, _CMP_EQ_OQ), v, atOne);
+            _mm512_storeu_ps(out + k, v);
+        }
+        return k;
+    }
+#endif
+}
+
+float Interpolate::lookup(const float t, const InterpolationType type)
+{
+    float out;
+    lookupScalar(easingTables()[std::clamp<int>(type, 0, INTERPOLATION_COUNT - 1)], &t, &out, 0, 1);
+    return out;
+}
+
+void Interpolate::interpolateBatch(const std::span<const float> in, const std::span<float> out,
+                                   const InterpolationType type, const SimdLevel level)
+{
+    const EasingTable& table = easingTables()[std::clamp<int>(type, 0, INTERPOLATION_COUNT - 1)];
+    const size_t count = std::min(in.size(), out.size());
+
+    // the vector kernels stop at the last whole vector, the scalar kernel finishes the tail
+    size_t done = 0;
+    switch (std::min(level, simdLevel()))
+    {
+#if SIMD_X86
+        case SimdLevel::AVX512: done = lookupAvx512(table, in.data(), out.data(), count); break;
+        case SimdLevel::AVX2:   done = lookupAvx2(table, in.data(), out.data(), count); break;
+        case SimdLevel::SSE:    done = lookupSse(table, in.data(), out.data(), count); break;
+#endif
+        default: break;
+    }
+    lookupScalar(table, in.data(), out.data(), done, count);
+}
+
+void EasingBuckets::resize(const size_t count)
+{
+    m_in.resize(count);
+    m_curves.resize(count);
+    m_out.resize(count);
+}
+
+void EasingBuckets::run()
+{
+    const size_t count = m_in.size();
+    if (count == 0) return;
+
+    // checked before counting, since counting one curve over and over is a chain of
+    // increments to the same counter
+    const InterpolationType first = m_curves[0];
+    if (std::all_of(m_curves.begin(), m_curves.end(), [first](const InterpolationType curve) { return curve == first; }))
+    {
+        Interpolate::interpolateBatch(m_in, m_out, first);
+        return;
+    }
+
+    // counting sort by curve, one batch per curve's range, then back into the callers' order
+    std::array<uint32_t, INTERPOLATION_COUNT + 1> begin{};
+    for (const InterpolationType curve : m_curves) begin[std::clamp<int>(curve, 0, INTERPOLATION_COUNT - 1) + 1]++;
+    for (int curve = 0; curve < INTERPOLATION_COUNT; curve++) begin[curve + 1] += begin[curve];
+
+    m_order.resize(count);
+    m_sortedIn.resize(count);
+    m_sortedOut.resize(count);
+    std::array<uint32_t, INTERPOLATION_COUNT> next{};
+    std::copy(begin.begin(), begin.end() - 1, next.begin());
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t slot = next[std::clamp<int>(m_curves[i], 0, INTERPOLATION_COUNT - 1)]++;
+        m_order[slot] = static_cast<uint32_t>(i);
+        m_sortedIn[slot] = m_in[i];
+    }
+
+    for (int curve = 0; curve < INTERPOLATION_COUNT; curve++)
+    {
+        const size_t size = begin[curve + 1] - begin[curve];
+        if (size == 0) continue;
+
+        Interpolate::interpolateBatch(std::span<const float>(m_sortedIn).subspan(begin[curve], size),
+                                      std::span<float>(m_sortedOut).subspan(begin[curve], size),
+                                      static_cast<InterpolationType>(curve));
+    }
+    for (size_t slot = 0; slot < count; slot++) m_out[m_order[slot]] = m_sortedOut[slot];
+}
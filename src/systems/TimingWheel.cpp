@@ -0,0 +1,33 @@
+//
+// Created by Jorge Jimenez on 8/4/25.
+//
+
+#include "TimingWheel.h"
+
+void TimingWheel::schedule(const EntityHandle entity, const uint32_t tick)
+{
+    insert({ entity, tick > m_now ? tick : m_now + 1 });
+}
+
+void TimingWheel::insert(const Entry& entry)
+{
+    // the finest wheel whose span still covers every bit the tick shares with now
+    int level = 0;
+    while (level < Levels - 1 && (entry.tick >> (SlotBits * (level + 1))) != (m_now >> (SlotBits * (level + 1))))
+    {
+        level++;
+    }
+
+    m_wheels[level][(entry.tick >> (SlotBits * level)) & SlotMask].push_back(entry);
+    m_size++;
+}
+
+void TimingWheel::reset(const uint32_t now)
+{
+    for (auto& wheel : m_wheels)
+    {
+        for (auto& slot : wheel) slot.clear();
+    }
+    m_now = now;
+    m_size = 0;
+}
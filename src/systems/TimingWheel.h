@@ -0,0 +1,105 @@
+//
+// Created by Jorge Jimenez on 8/4/25.
+//
+
+#pragma once
+
+#include "../entity/Entity.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Hierarchical timing wheel, hands back entities on the tick they were scheduled for
+ *
+ * Four wheels of 256 slots each cover the ticks 256, 65536, 16M and 4G ahead. An entity
+ * goes into the coarsest wheel it needs and drops into finer wheels as its tick gets
+ * closer, a whole slot at a time, so each entity is moved at most three times however far
+ * ahead it was scheduled. advance() only touches the slots whose time has come, so a
+ * tick costs the entities expiring on it plus the occasional cascade, not a pass over
+ * every timed entity.
+ *
+ * Entries are never removed early. An entity that dies or gets rescheduled before its
+ * tick is still handed back, the caller checks whether it is really due.
+ *
+ * @example
+ * const CLifespan& lifespan = entities.add<CLifespan>(entity, 60, tick);
+ * wheel.schedule(entity, lifespan.expiresAt);
+ *
+ * // once per tick
+ * wheel.advance(tick, [&](EntityHandle e) {
+ *     const CLifespan* lifespan = entities.find<CLifespan>(e);
+ *     if (lifespan && lifespan->expiresAt <= tick) entities.destroy(e);
+ * });
+ */
+class TimingWheel
+{
+    static constexpr int      SlotBits = 8;
+    static constexpr uint32_t Slots    = 1u << SlotBits;
+    static constexpr uint32_t SlotMask = Slots - 1;
+    static constexpr int      Levels   = 4;
+
+    struct Entry
+    {
+        EntityHandle entity;
+        uint32_t     tick = 0;
+    };
+
+    using Wheel = std::array<std::vector<Entry>, Slots>;
+
+    std::array<Wheel, Levels> m_wheels;
+    uint32_t m_now = 0;   ///< Last tick advanced to
+    size_t   m_size = 0;
+
+    void insert(const Entry& entry);
+
+public:
+    /// Hands entity back on the given tick, or on the next tick if that one has passed
+    void schedule(EntityHandle entity, uint32_t tick);
+
+    /**
+     * @brief Moves time forward to now, calling expire(entity) for every entity due on the way
+     *
+     * Ticks skipped since the last call are stepped through one at a time, so nothing
+     * due in between is missed.
+     */
+    template <typename F>
+    void advance(const uint32_t now, F&& expire)
+    {
+        while (m_now < now)
+        {
+            m_now++;
+
+            // when a finer wheel wraps around, empty the coarser wheels' current slots into it
+            for (int level = Levels - 1; level > 0; level--)
+            {
+                if ((m_now & ((1u << (SlotBits * level)) - 1)) != 0) continue;
+
+                auto& slot = m_wheels[level][(m_now >> (SlotBits * level)) & SlotMask];
+                for (const Entry& entry : slot) insert(entry);
+                m_size -= slot.size();
+                slot.clear();
+            }
+
+            auto& due = m_wheels[0][m_now & SlotMask];
+            for (const Entry& entry : due) expire(entry.entity);
+            m_size -= due.size();
+            due.clear();
+        }
+    }
+
+    /// Tick advance() last reached
+    [[nodiscard]] uint32_t now() const
+    {
+        return m_now;
+    }
+
+    /// Entities waiting for their tick
+    [[nodiscard]] size_t size() const
+    {
+        return m_size;
+    }
+
+    /// Forgets every entity and restarts time at the given tick
+    void reset(uint32_t now = 0);
+};
@@ -0,0 +1,201 @@
+//
+// Created by Jorge Jimenez on 8/2/25.
+//
+
+#include "TweenSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace
+{
+    uint8_t toChannel(const float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f);
+    }
+
+    /// Current value of a property, or nothing if the entity is gone or lacks its component
+    std::optional<TweenValue> read(EntityManager& entities, const EntityHandle entity, const TweenProperty property)
+    {
+        switch (property)
+        {
+            case TWEEN_RADIUS:
+            case TWEEN_COLOR:
+            {
+                const CShape* shape = entities.find<CShape>(entity);
+                if (!shape) return std::nullopt;
+                return property == TWEEN_RADIUS ? TweenValue(shape->getRadius()) : TweenValue(shape->getFillColor());
+            }
+            case TWEEN_POSITION:
+            case TWEEN_ROTATION:
+            default:
+            {
+                const CTransform* transform = entities.find<CTransform>(entity);
+                if (!transform) return std::nullopt;
+                return property == TWEEN_POSITION ? TweenValue(transform->pos) : TweenValue(transform->angle);
+            }
+        }
+    }
+
+    /// Writes a property, returning false if the entity is gone or lacks its component
+    bool write(EntityManager& entities, const EntityHandle entity, const TweenProperty property,
+               const std::array<float, 4>& v)
+    {
+        switch (property)
+        {
+            case TWEEN_POSITION:
+            {
+                CTransform* transform = entities.find<CTransform>(entity);
+                if (!transform) return false;
+                transform->pos = Vec2f(v[0], v[1]);
+                return true;
+            }
+            case TWEEN_RADIUS:
+            {
+                CShape* shape = entities.find<CShape>(entity);
+                if (!shape) return false;
+                // elastic curves overshoot, a radius can't go below zero
+                shape->setRadius(std::max(v[0], 0.0f));
+                return true;
+            }
+            case TWEEN_COLOR:
+            {
+                CShape* shape = entities.find<CShape>(entity);
+                if (!shape) return false;
+                shape->setFillColor(sf::Color(toChannel(v[0]), toChannel(v[1]), toChannel(v[2]), toChannel(v[3])));
+                return true;
+            }
+            case TWEEN_ROTATION:
+            default:
+            {
+                CTransform* transform = entities.find<CTransform>(entity);
+                if (!transform) return false;
+                transform->angle = v[0];
+                return true;
+            }
+        }
+    }
+}
+
+TweenSystem::Sequence& TweenSystem::Sequence::to(const TweenProperty property, const TweenValue& value,
+                                                 const int duration, const InterpolationType curve)
+{
+    m_stepStart = m_end;
+    return with(property, value, duration, curve);
+}
+
+TweenSystem::Sequence& TweenSystem::Sequence::with(const TweenProperty property, const TweenValue& value,
+                                                   const int duration, const InterpolationType curve)
+{
+    Tween tween;
+    tween.to          = value;
+    tween.entity      = m_entity;
+    tween.delay       = m_stepStart;
+    tween.duration    = std::max(duration, 1);
+    tween.property    = property;
+    tween.curve       = curve;
+    tween.fromCurrent = true;
+    m_system.m_waiting.push_back(tween);
+
+    m_end = std::max(m_end, m_stepStart + tween.duration);
+    return *this;
+}
+
+void TweenSystem::add(const EntityHandle entity, const TweenProperty property, const TweenValue& from,
+                      const TweenValue& to, const int duration, const InterpolationType curve, const int delay)
+{
+    Tween tween;
+    tween.from     = from;
+    tween.to       = to;
+    tween.entity   = entity;
+    tween.delay    = delay;
+    tween.duration = std::max(duration, 1);
+    tween.property = property;
+    tween.curve    = curve;
+
+    if (delay > 0) m_waiting.push_back(tween);
+    else start(tween, from);
+}
+
+void TweenSystem::start(const Tween& tween, const TweenValue& from)
+{
+    m_clocks.push_back({ 0, tween.duration });
+    m_curves.push_back(tween.curve);
+    m_targets.push_back({ from, tween.to, tween.entity, tween.property });
+}
+
+void TweenSystem::cancel(const EntityHandle entity)
+{
+    std::erase_if(m_waiting, [entity](const Tween& tween) { return tween.entity == entity; });
+    dropRunning([&](const size_t i) { return m_targets[i].entity == entity; });
+}
+
+void TweenSystem::clear()
+{
+    m_waiting.clear();
+    m_clocks.clear();
+    m_curves.clear();
+    m_targets.clear();
+}
+
+void TweenSystem::update(EntityManager& entities)
+{
+    // 1) start the tweens whose delay ran out, a chained step picks up where its property is now
+    size_t waiting = 0;
+    for (size_t i = 0; i < m_waiting.size(); i++)
+    {
+        Tween& tween = m_waiting[i];
+        if (tween.delay > 0)
+        {
+            tween.delay--;
+            m_waiting[waiting++] = tween;
+            continue;
+        }
+
+        if (!tween.fromCurrent)
+        {
+            start(tween, tween.from);
+        }
+        else if (const auto from = read(entities, tween.entity, tween.property))
+        {
+            start(tween, *from);
+        }
+    }
+    m_waiting.resize(waiting);
+
+    // 2) tick every clock and ease every progress, one batch per curve
+    const size_t count = m_clocks.size();
+    m_easing.resize(count);
+    const auto progress = m_easing.in();
+    for (size_t i = 0; i < count; i++)
+    {
+        Clock& clock = m_clocks[i];
+        clock.elapsed++;
+        progress[i] = std::min(static_cast<float>(clock.elapsed) / static_cast<float>(clock.duration), 1.0f);
+    }
+    std::copy(m_curves.begin(), m_curves.end(), m_easing.curves().begin());
+    m_easing.run();
+    const auto eased = m_easing.out();
+
+    // 3) write the values in the order the tweens started, so later tweens win
+    size_t done = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Target& target = m_targets[i];
+        std::array<float, 4> value;
+        for (size_t c = 0; c < value.size(); c++)
+        {
+            value[c] = target.from.v[c] + (target.to.v[c] - target.from.v[c]) * eased[i];
+        }
+
+        if (!write(entities, target.entity, target.property, value))
+        {
+            // the entity is gone, finish the tween so it is dropped below
+            m_clocks[i].elapsed = m_clocks[i].duration;
+        }
+        if (m_clocks[i].elapsed >= m_clocks[i].duration) done++;
+    }
+
+    // 4) drop the tweens that just wrote their final value
+    if (done > 0) dropRunning([this](const size_t i) { return m_clocks[i].elapsed >= m_clocks[i].duration; });
+}
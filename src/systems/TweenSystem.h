@@ -0,0 +1,189 @@
+//
+// Created by Jorge Jimenez on 8/2/25.
+//
+
+#pragma once
+
+#include "Systems.h"
+#include "../entitymanager/EntityManager.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Component fields a tween can animate
+enum TweenProperty : uint8_t
+{
+    TWEEN_POSITION,  // CTransform::pos
+    TWEEN_RADIUS,    // CShape radius
+    TWEEN_COLOR,     // CShape fill color, alpha included
+    TWEEN_ROTATION,  // CTransform::angle
+    TWEEN_PROPERTY_COUNT
+};
+
+inline constexpr const char* TweenPropertyNames[] = {
+    "Position",
+    "Radius",
+    "Color",
+    "Rotation",
+};
+
+/**
+ * @brief Value of any tweenable property, up to four floats
+ *
+ * Converts from the type each property uses, so callers can pass a Vec2f for a
+ * position, a float for a radius or rotation and an sf::Color for a color.
+ */
+struct TweenValue
+{
+    std::array<float, 4> v{};
+
+    TweenValue() = default;
+    TweenValue(const float value) : v{ value, 0, 0, 0 } {}
+    TweenValue(const Vec2f& value) : v{ value.x, value.y, 0, 0 } {}
+    TweenValue(const sf::Color& value)
+        : v{ static_cast<float>(value.r), static_cast<float>(value.g),
+             static_cast<float>(value.b), static_cast<float>(value.a) } {}
+};
+
+/**
+ * @brief Animates component fields along easing curves, every active tween in one pass per tick
+ *
+ * Tweens live in packed arrays instead of on the entities. Running tweens keep their
+ * clocks, curves and targets in separate columns, so update() ticks every clock and
+ * eases every progress in one EasingBuckets batch per curve without touching the
+ * targets, then walks the targets once to write the values into the components.
+ * Tweens still waiting out a delay sit in their own array and only cost a decrement.
+ * Finished tweens, and those whose entity died, are dropped after the write. Durations
+ * and delays are in simulation ticks.
+ *
+ * A tween either starts from a given value or, when added through a Sequence, from
+ * whatever the property holds the tick it starts, so steps chain without repeating
+ * where the last one ended. When two tweens drive the same property in one tick the
+ * one that started last wins.
+ *
+ * @example
+ * // pop in, then wait a second and fade out while spinning
+ * tweens.add(e, TWEEN_RADIUS, 0.0f, 20.0f, 30, EASEOUT_ELASTIC);
+ * tweens.sequence(e, 30)
+ *     .wait(60)
+ *     .to(TWEEN_COLOR, sf::Color(255, 255, 255, 0), 45, EASEIN_SINE)
+ *     .with(TWEEN_ROTATION, 360.0f, 45, EASEINOUT_SINE);
+ *
+ * // once per tick
+ * tweens.update(entities);
+ */
+class TweenSystem : Systems
+{
+    /// A tween as it was added, kept aside until its delay runs out
+    struct Tween
+    {
+        TweenValue        from;
+        TweenValue        to;
+        EntityHandle      entity;
+        int               delay    = 0;  ///< Ticks left before it starts
+        int               duration = 1;
+        TweenProperty     property = TWEEN_POSITION;
+        InterpolationType curve    = EASEIN_SINE;
+        bool              fromCurrent = false;  ///< Read from when it starts instead of using the given one
+    };
+
+    struct Clock
+    {
+        int elapsed  = 0;  ///< Ticks since it started
+        int duration = 1;
+    };
+
+    struct Target
+    {
+        TweenValue    from;
+        TweenValue    to;
+        EntityHandle  entity;
+        TweenProperty property = TWEEN_POSITION;
+    };
+
+    std::vector<Tween> m_waiting;
+
+    // running tweens, row i of each describes the same tween, in the order they started
+    std::vector<Clock>             m_clocks;
+    std::vector<InterpolationType> m_curves;
+    std::vector<Target>            m_targets;
+
+    EasingBuckets m_easing;
+
+    void start(const Tween& tween, const TweenValue& from);
+
+    /// Removes the running tweens drop(row) picks, keeping the order of the rest
+    template <typename Drop>
+    void dropRunning(Drop&& drop)
+    {
+        size_t live = 0;
+        for (size_t i = 0; i < m_clocks.size(); i++)
+        {
+            if (drop(i)) continue;
+            m_clocks[live] = m_clocks[i];
+            m_curves[live] = m_curves[i];
+            m_targets[live] = m_targets[i];
+            live++;
+        }
+        m_clocks.resize(live);
+        m_curves.resize(live);
+        m_targets.resize(live);
+    }
+
+public:
+    /**
+     * @brief Steps run one after another on a single entity, each starting where the property is by then
+     *
+     * to() starts after the previous step ends, with() runs alongside the previous
+     * step, and wait() leaves a gap.
+     */
+    class Sequence
+    {
+        TweenSystem& m_system;
+        EntityHandle m_entity;
+        int          m_stepStart = 0;  ///< Tick the previous step started at
+        int          m_end       = 0;  ///< Tick everything so far has finished by
+
+    public:
+        Sequence(TweenSystem& system, const EntityHandle entity, const int delay)
+            : m_system(system), m_entity(entity), m_stepStart(delay), m_end(delay)
+        {}
+
+        Sequence& to(TweenProperty property, const TweenValue& value, int duration, InterpolationType curve);
+        Sequence& with(TweenProperty property, const TweenValue& value, int duration, InterpolationType curve);
+        Sequence& wait(const int ticks)
+        {
+            m_end += ticks;
+            m_stepStart = m_end;
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Tweens a property of an entity from one value to another
+     *
+     * The entity must have the component the property lives in.
+     */
+    void add(EntityHandle entity, TweenProperty property, const TweenValue& from, const TweenValue& to,
+             int duration, InterpolationType curve, int delay = 0);
+
+    /// Starts a chain of tweens on an entity, delay ticks from now
+    [[nodiscard]] Sequence sequence(const EntityHandle entity, const int delay = 0)
+    {
+        return Sequence(*this, entity, delay);
+    }
+
+    /// Drops every tween of an entity, leaving its properties where they are
+    void cancel(EntityHandle entity);
+
+    /// Advances every tween by one tick and writes the eased values into the components
+    void update(EntityManager& entities);
+
+    /// Tweens running or waiting to start
+    [[nodiscard]] size_t size() const
+    {
+        return m_waiting.size() + m_clocks.size();
+    }
+
+    void clear();
+};